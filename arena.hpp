@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+namespace sym {
+
+/// allocation statistics of an `arena_resource`
+///
+struct arena_stats
+{
+  /// number of allocations since construction or the last `release`
+  ///
+  std::size_t allocations{};
+
+  /// number of bytes allocated since construction or the last `release`
+  ///
+  std::size_t bytes{};
+
+  /// number of regions obtained from the upstream resource
+  ///
+  std::size_t regions{};
+
+  /// total size of the regions
+  ///
+  std::size_t capacity{};
+};
+
+/// monotonic bump allocator memory resource
+///
+/// Allocates from a contiguous region obtained from an upstream resource by
+/// advancing a pointer. When a region is exhausted, a new region at least
+/// twice as large is obtained. Deallocation does nothing; memory is reclaimed
+/// all at once by `release` or destruction.
+///
+/// `release` replaces all regions with a single region as large as their
+/// total, so that after the first request of a workload, each request is
+/// allocated from one contiguous region.
+///
+/// Use as the memory resource of `std::pmr` symbols, expressions, and
+/// containers:
+///
+/// ~~~{.cpp}
+/// auto arena = arena_resource{};
+/// const auto alloc = std::pmr::polymorphic_allocator<>{&arena};
+///
+/// auto x = symbol{std::pmr::string{"x", alloc}}[constraint::positive];
+/// auto y = symbol{std::pmr::string{"y", alloc}}[constraint::negative];
+///
+/// auto exprs = std::pmr::vector<decltype(x + y)>{alloc};
+/// exprs.push_back(plus(std::allocator_arg, alloc, x, y));
+///
+/// arena.release();
+/// ~~~
+///
+/// Not thread-safe.
+///
+class arena_resource : public std::pmr::memory_resource
+{
+  struct region
+  {
+    region* next;
+    std::size_t size;
+  };
+
+  static constexpr auto region_alignment = alignof(std::max_align_t);
+
+  std::pmr::memory_resource* upstream_;
+  region* head_{};
+  std::byte* cursor_{};
+  std::size_t space_{};
+  std::size_t next_size_;
+  arena_stats stats_{};
+
+  auto grow(std::size_t min_size) -> void
+  {
+    const auto size =
+        std::max(next_size_, sizeof(region) + min_size + region_alignment);
+
+    auto* const r = ::new (upstream_->allocate(size, region_alignment))
+        region{head_, size};
+
+    head_ = r;
+    cursor_ = reinterpret_cast<std::byte*>(r) + sizeof(region);
+    space_ = size - sizeof(region);
+    next_size_ = size * 2;
+
+    ++stats_.regions;
+    stats_.capacity += size;
+  }
+
+  auto free_regions() -> void
+  {
+    while (head_ != nullptr) {
+      auto* const next = head_->next;
+      upstream_->deallocate(head_, head_->size, region_alignment);
+      head_ = next;
+    }
+    cursor_ = nullptr;
+    space_ = 0;
+  }
+
+protected:
+  auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override
+  {
+    void* p = cursor_;
+    if (std::align(alignment, bytes, p, space_) == nullptr) {
+      grow(bytes + alignment);
+      p = cursor_;
+      std::align(alignment, bytes, p, space_);
+    }
+
+    cursor_ = static_cast<std::byte*>(p) + bytes;
+    space_ -= bytes;
+
+    ++stats_.allocations;
+    stats_.bytes += bytes;
+    return p;
+  }
+
+  auto do_deallocate(void*, std::size_t, std::size_t) -> void override {}
+
+  [[nodiscard]]
+  auto do_is_equal(const std::pmr::memory_resource& other) const noexcept
+      -> bool override
+  {
+    return this == &other;
+  }
+
+public:
+  /// constructs an arena with an initial region of `initial_size` bytes
+  ///
+  explicit arena_resource(
+      std::size_t initial_size = 64U * 1024U,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : upstream_{upstream}, next_size_{initial_size}
+  {
+    assert(upstream != nullptr);
+    grow(0);
+  }
+
+  arena_resource(const arena_resource&) = delete;
+  auto operator=(const arena_resource&) -> arena_resource& = delete;
+
+  ~arena_resource() override { free_regions(); }
+
+  /// reclaims all allocated memory at once
+  ///
+  /// Memory allocated from the arena must not be used afterwards.
+  ///
+  auto release() -> void
+  {
+    const auto capacity = stats_.capacity;
+    free_regions();
+
+    stats_ = {};
+    next_size_ = capacity;
+    grow(0);
+  }
+
+  [[nodiscard]]
+  auto stats() const -> const arena_stats&
+  {
+    return stats_;
+  }
+
+  [[nodiscard]]
+  auto upstream_resource() const -> std::pmr::memory_resource*
+  {
+    return upstream_;
+  }
+};
+
+}  // namespace sym
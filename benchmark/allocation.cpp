@@ -0,0 +1,232 @@
+#include "sym.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace sym;
+
+// compares heap allocations and fragmentation of building a request's
+// runtime expressions with the default allocator and with an arena
+//
+// fragmentation is the fraction of the address range spanned by a request's
+// heap allocations that is not occupied by its peak live bytes
+
+namespace {
+
+constexpr auto requests = 64;
+constexpr auto expressions_per_request = std::size_t{1024};
+
+struct heap_stats
+{
+  std::size_t allocations{};
+  std::size_t live{};
+  std::size_t peak{};
+  std::uintptr_t lowest{UINTPTR_MAX};
+  std::uintptr_t highest{};
+};
+
+auto heap = heap_stats{};
+
+// each heap allocation is preceded by a header storing its size
+auto allocate(std::size_t size, std::size_t alignment) -> void*
+{
+  alignment = std::max(alignment, alignof(std::max_align_t));
+  const auto total = (size + (2 * alignment) - 1) / alignment * alignment;
+
+  auto* const base =
+      static_cast<std::byte*>(std::aligned_alloc(alignment, total));
+  if (base == nullptr) {
+    throw std::bad_alloc{};
+  }
+  auto* const p = base + alignment;
+  std::memcpy(p - sizeof(std::size_t), &size, sizeof(size));
+
+  const auto address = reinterpret_cast<std::uintptr_t>(p);
+  ++heap.allocations;
+  heap.live += size;
+  heap.peak = std::max(heap.peak, heap.live);
+  heap.lowest = std::min(heap.lowest, address);
+  heap.highest = std::max(heap.highest, address + size);
+  return p;
+}
+
+auto deallocate(void* ptr, std::size_t alignment) -> void
+{
+  if (ptr == nullptr) {
+    return;
+  }
+  alignment = std::max(alignment, alignof(std::max_align_t));
+
+  auto* const p = static_cast<std::byte*>(ptr);
+  auto size = std::size_t{};
+  std::memcpy(&size, p - sizeof(std::size_t), sizeof(size));
+
+  heap.live -= std::min(heap.live, size);
+  std::free(p - alignment);
+}
+
+// formats a symbol name longer than the small string buffer without
+// allocating
+auto name(std::array<char, 64>& buffer, char prefix, std::size_t i)
+    -> std::string_view
+{
+  constexpr auto stem = std::string_view{"_request_symbol_"};
+
+  buffer.front() = prefix;
+  auto* const digits = std::ranges::copy(stem, buffer.data() + 1).out;
+  const auto [last, _] =
+      std::to_chars(digits, buffer.data() + buffer.size(), i);
+  return {buffer.data(), last};
+}
+
+struct report
+{
+  double us{};
+  std::size_t allocations{};
+  std::size_t peak{};
+  std::size_t span{};
+};
+
+template <class Build>
+auto measure(Build build) -> report
+{
+  auto total = report{};
+  for (auto r = 0; r != requests; ++r) {
+    heap = {};
+    const auto start = std::chrono::steady_clock::now();
+    build();
+    const auto stop = std::chrono::steady_clock::now();
+
+    total.us +=
+        std::chrono::duration<double, std::micro>(stop - start).count();
+    total.allocations += heap.allocations;
+    total.peak += heap.peak;
+    total.span += heap.allocations == 0 ? 0 : heap.highest - heap.lowest;
+  }
+  return total;
+}
+
+auto print(const char* mode, const report& r) -> void
+{
+  const auto per_request = [](auto value) {
+    return static_cast<double>(value) / requests;
+  };
+  const auto peak = per_request(r.peak);
+  const auto span = per_request(r.span);
+
+  std::cout << mode << ":\n"
+            << "  time per request: " << per_request(r.us) << " us\n"
+            << "  heap allocations per request: "
+            << per_request(r.allocations) << "\n"
+            << "  peak live heap bytes per request: " << peak << "\n"
+            << "  heap address span per request: " << span << " bytes\n"
+            << "  fragmentation: " << (span == 0 ? 0.0 : 1.0 - (peak / span))
+            << "\n";
+}
+
+}  // namespace
+
+auto operator new(std::size_t size) -> void*
+{
+  return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void*
+{
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+auto operator delete(void* p) noexcept -> void
+{
+  deallocate(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+auto operator delete(void* p, std::size_t) noexcept -> void
+{
+  deallocate(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+auto operator delete(void* p, std::align_val_t alignment) noexcept -> void
+{
+  deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+auto operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+    -> void
+{
+  deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+auto main() -> int
+{
+  using expression_type = decltype(plus(
+      symbol{std::string{}}[constraint::positive],
+      plus(
+          symbol{std::string{}}[constraint::positive],
+          symbol{std::string{}}[constraint::negative])));
+
+  const auto before = measure([] {
+    auto buffer = std::array<char, 64>{};
+    auto exprs = std::vector<expression_type>{};
+    for (auto i = std::size_t{}; i != expressions_per_request; ++i) {
+      auto x =
+          symbol{std::string{name(buffer, 'x', i)}}[constraint::positive];
+      auto y =
+          symbol{std::string{name(buffer, 'y', i)}}[constraint::positive];
+      auto z =
+          symbol{std::string{name(buffer, 'z', i)}}[constraint::negative];
+      exprs.push_back(plus(x, plus(y, z)));
+    }
+  });
+
+  using pmr_expression_type = decltype(plus(
+      symbol{std::pmr::string{}}[constraint::positive],
+      plus(
+          symbol{std::pmr::string{}}[constraint::positive],
+          symbol{std::pmr::string{}}[constraint::negative])));
+
+  auto arena = arena_resource{};
+  auto arena_bytes = std::size_t{};
+  const auto after = measure([&arena, &arena_bytes] {
+    const auto alloc = std::pmr::polymorphic_allocator<>{&arena};
+    {
+      auto buffer = std::array<char, 64>{};
+      auto exprs = std::pmr::vector<pmr_expression_type>{alloc};
+      for (auto i = std::size_t{}; i != expressions_per_request; ++i) {
+        auto x = symbol{std::pmr::string{name(buffer, 'x', i), alloc}}
+            [constraint::positive];
+        auto y = symbol{std::pmr::string{name(buffer, 'y', i), alloc}}
+            [constraint::positive];
+        auto z = symbol{std::pmr::string{name(buffer, 'z', i), alloc}}
+            [constraint::negative];
+        exprs.push_back(plus(
+            std::allocator_arg,
+            alloc,
+            x,
+            plus(std::allocator_arg, alloc, y, z)));
+      }
+    }
+    arena_bytes += arena.stats().bytes;
+    arena.release();
+  });
+
+  print("default allocator", before);
+  print("arena", after);
+  std::cout << "  arena bytes per request: "
+            << static_cast<double>(arena_bytes) / requests << "\n"
+            << "  arena capacity: " << arena.stats().capacity << " bytes in "
+            << arena.stats().regions << " region\n";
+}
@@ -0,0 +1,111 @@
+#include "sym.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sym;
+
+// compares validating runtime expressions one at a time, as each is
+// constructed, with constructing them unchecked and validating them all at
+// once with `validate_batch` using different numbers of threads
+//
+// every expression is consistent so that checked construction does not assert
+//
+// thread counts are powers of two up to the hardware concurrency, or up to:
+//   bazel run //:batch_benchmark --copt=-DSYM_BATCH_MAX_THREADS=16
+
+namespace {
+
+constexpr auto expression_count = std::size_t{1} << 18U;
+constexpr auto repetitions = 8;
+
+template <class F>
+auto time(F f) -> double
+{
+  auto best = 0.0;
+  for (auto r = 0; r != repetitions; ++r) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto ms =
+        std::chrono::duration<double, std::milli>(stop - start).count();
+    best = r == 0 ? ms : std::min(best, ms);
+  }
+  return best;
+}
+
+auto report(const char* mode, std::size_t threads, double ms) -> void
+{
+  std::cout << mode << ", threads: " << threads << ": " << ms << " ms, "
+            << static_cast<double>(expression_count) / ms / 1e3
+            << " Mexpr/s\n";
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  using positive_symbol =
+      decltype(symbol{std::string{}}[constraint::positive]);
+  using negative_symbol =
+      decltype(symbol{std::string{}}[constraint::negative]);
+
+  auto xs = std::vector<positive_symbol>{};
+  auto ys = std::vector<negative_symbol>{};
+  for (auto i = std::size_t{}; i != expression_count; ++i) {
+    xs.push_back(symbol{"x" + std::to_string(i % 1024)}[constraint::positive]);
+    ys.push_back(symbol{"y" + std::to_string(i % 1024)}[constraint::negative]);
+  }
+
+  // `x + (y + x)` repeats a symbol so that validation compares constraints
+  using expression_type = decltype(xs.front() + (ys.front() + xs.front()));
+
+  auto expressions = std::vector<expression_type>{};
+  expressions.reserve(expression_count);
+
+  const auto checked = time([&] {
+    expressions.clear();
+    for (auto i = std::size_t{}; i != expression_count; ++i) {
+      expressions.push_back(xs[i] + (ys[i] + xs[i]));
+    }
+  });
+  report("one at a time", 1, checked);
+
+  auto views = std::vector<any_expression_view>{};
+  views.reserve(expression_count);
+
+#ifdef SYM_BATCH_MAX_THREADS
+  const auto max_threads = std::size_t{SYM_BATCH_MAX_THREADS};
+#else
+  const auto max_threads = std::max(
+      std::size_t{1}, std::size_t{std::thread::hardware_concurrency()});
+#endif
+
+  for (auto threads = std::size_t{1}; threads <= max_threads; threads *= 2) {
+    auto failures = std::size_t{};
+    const auto batch = time([&] {
+      expressions.clear();
+      views.clear();
+      for (auto i = std::size_t{}; i != expression_count; ++i) {
+        expressions.push_back(
+            plus(unchecked, xs[i], plus(unchecked, ys[i], xs[i])));
+      }
+      for (const auto& ex : expressions) {
+        views.emplace_back(ex);
+      }
+      failures += validate_batch(views, {.threads = threads}).failure_count();
+    });
+    report("batch", threads, batch);
+
+    if (failures != 0) {
+      std::cout << "unexpected failures: " << failures << "\n";
+      return 1;
+    }
+  }
+}
@@ -0,0 +1,59 @@
+#include "sym.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <utility>
+
+using namespace sym;
+
+// tracks binary size and cold printing time of many distinct expression types
+//
+// reports the default and compact modes side by side:
+//   bazel run //:codegen_benchmark
+//
+// equal output hashes show that both modes print the same output
+
+namespace {
+
+constexpr auto formula_count = std::size_t{256};
+
+template <std::size_t I>
+constexpr auto formula()
+{
+  constexpr auto bound = constraint::ordered{
+      constant<-static_cast<constraint::real_type>(I + 1)>{},
+      constant<constraint::real_type{}>{}};
+
+  return "x"_symbol[bound] + ("y"_symbol + "z"_symbol[bound]);
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int
+{
+  auto os = std::ostringstream{};
+
+  const auto start = std::chrono::steady_clock::now();
+  [&os]<std::size_t... Is>(std::index_sequence<Is...>) {
+    ((os << formula<Is>() << "\n"), ...);
+  }(std::make_index_sequence<formula_count>{});
+  const auto stop = std::chrono::steady_clock::now();
+
+  const auto us = std::chrono::duration<double, std::micro>(stop - start);
+
+#ifdef SYM_COMPACT_CODEGEN
+  const auto* mode = "compact";
+#else
+  const auto* mode = "default";
+#endif
+  std::cout << mode << ": binary size: "
+            << std::filesystem::file_size(argv[0]) << " bytes, "
+            << formula_count << " expression types, first print: "
+            << us.count() << " us, output hash: " << std::hex
+            << std::hash<std::string_view>{}(os.view()) << "\n";
+}
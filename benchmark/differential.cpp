@@ -0,0 +1,227 @@
+#include "sym.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace sym;
+
+// differential test of static and runtime constraint propagation on random
+// expression trees, reporting the cost of the runtime path
+//
+// the static path reads the constraint computed by `op::plus::constraint` on
+// `constant<>` bounds. it is evaluated during compilation and has no runtime
+// cost to report. the runtime path applies each op's constraint rule to
+// `any_ordered` symbol bounds read from memory, as for expressions whose
+// bounds are only known at runtime. results must match exactly.
+//
+// configure the tree shape with:
+//   bazel run //:differential_benchmark
+//     --copt=-DSYM_DIFFERENTIAL_DEPTH=6
+//     --copt=-DSYM_DIFFERENTIAL_SEED=42
+//     --copt=-DSYM_DIFFERENTIAL_TREES=32
+
+#ifndef SYM_DIFFERENTIAL_DEPTH
+#define SYM_DIFFERENTIAL_DEPTH 5
+#endif
+
+#ifndef SYM_DIFFERENTIAL_SEED
+#define SYM_DIFFERENTIAL_SEED 1
+#endif
+
+#ifndef SYM_DIFFERENTIAL_TREES
+#define SYM_DIFFERENTIAL_TREES 16
+#endif
+
+namespace {
+
+constexpr auto max_depth = std::size_t{SYM_DIFFERENTIAL_DEPTH};
+constexpr auto seed = std::uint64_t{SYM_DIFFERENTIAL_SEED};
+constexpr auto tree_count = std::size_t{SYM_DIFFERENTIAL_TREES};
+constexpr auto repetitions = 100'000;
+
+static_assert(max_depth != 0);
+
+// splitmix64
+constexpr auto next(std::uint64_t state) -> std::uint64_t
+{
+  state += 0x9e3779b97f4a7c15U;
+  state = (state ^ (state >> 30U)) * 0xbf58476d1ce4e5b9U;
+  state = (state ^ (state >> 27U)) * 0x94d049bb133111ebU;
+  return state ^ (state >> 31U);
+}
+
+// random bound of the symbol with index `I`
+//
+// mins and maxes are drawn independently, from a stream separate from the
+// tree shapes, so that the min and the max of an aggregate usually come from
+// different symbols
+template <std::size_t I, std::uint64_t Stream>
+constexpr auto random_bound = static_cast<constraint::real_type>(
+    next(~seed ^ ((2 * I) + Stream)) % 64);
+
+template <std::size_t I>
+constexpr auto bound = constraint::ordered{
+    constant<-random_bound<I, 0>>{}, constant<random_bound<I, 1>>{}};
+
+// each symbol has the same constraint in every tree
+constexpr auto symbols = std::tuple{
+    "a"_symbol[bound<0>],
+    "b"_symbol[bound<1>],
+    "c"_symbol[bound<2>],
+    "d"_symbol[bound<3>],
+    "e"_symbol[bound<4>],
+    "f"_symbol[bound<5>],
+    "g"_symbol[bound<6>],
+    "h"_symbol[bound<7>]};
+
+constexpr auto symbol_count = std::tuple_size_v<decltype(symbols)>;
+
+// random tree of `plus` with leaves becoming likely below the root
+template <std::uint64_t State, std::size_t Depth>
+constexpr auto tree()
+{
+  constexpr auto r = next(State);
+
+  if constexpr (Depth == 0 or (Depth != max_depth and r % 4 == 0)) {
+    return std::get<(r >> 8U) % symbol_count>(symbols);
+  } else {
+    return tree<next(r), Depth - 1>() + tree<next(~r), Depth - 1>();
+  }
+}
+
+// number of symbols and expressions in a tree
+template <class T>
+struct node_count : std::integral_constant<std::size_t, 1>
+{};
+
+template <class Op, class... Args, class Constraint>
+struct node_count<expression<Op, std::tuple<Args...>, Constraint>>
+    : std::integral_constant<
+          std::size_t,
+          1 + (node_count<Args>::value + ...)>
+{};
+
+// runtime path
+template <class... Ts>
+auto propagate_runtime(
+    const symbol<Ts...>& s, std::span<const constraint::any_ordered> bounds)
+    -> constraint::any_ordered
+{
+  return bounds[static_cast<std::size_t>(s.name().front() - 'a')];
+}
+
+template <class Op, class Args, class Constraint>
+auto propagate_runtime(
+    const expression<Op, Args, Constraint>& ex,
+    std::span<const constraint::any_ordered> bounds) -> constraint::any_ordered
+{
+  return std::apply(
+      [bounds](const auto&... args) {
+        return typename Op::constraint{}(propagate_runtime(args, bounds)...);
+      },
+      ex.args());
+}
+
+// `true` if no single symbol has both bounds of the aggregate constraint `c`
+template <class Expression>
+auto split_bounds(
+    const Expression& ex,
+    std::span<const constraint::any_ordered> bounds,
+    const constraint::any_ordered& c) -> bool
+{
+  auto single = false;
+  auto v = [&]<class... Ts>(const symbol<Ts...>& s) {
+    single = single or propagate_runtime(s, bounds) == c;
+  };
+  ex.visit(std::ref(v));
+  return not single;
+}
+
+struct totals
+{
+  std::size_t trees{};
+  std::size_t nodes{};
+  std::size_t split{};
+  std::size_t mismatches{};
+  double runtime_ns{};
+  double checksum{};
+};
+
+template <class F>
+auto time(F f, double& checksum) -> double
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (auto r = 0; r != repetitions; ++r) {
+    const auto c = f();
+    checksum += c.min() + c.max();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+template <class Expression>
+auto run(
+    const Expression& ex,
+    std::span<const constraint::any_ordered> bounds,
+    totals& t) -> void
+{
+  // static path, evaluated during compilation
+  constexpr auto expected = constraint::any_ordered{
+      std::remove_cvref_t<decltype(ex.constraint())>{}};
+
+  if (not(propagate_runtime(ex, bounds) == expected and
+          propagate(ex) == expected and
+          any_expression_view{ex}.propagate() == expected)) {
+    ++t.mismatches;
+    std::cout << "mismatch: " << ex << "\n"
+              << "  static: " << expected << "\n"
+              << "  runtime: " << propagate_runtime(ex, bounds) << "\n";
+  }
+
+  ++t.trees;
+  t.nodes += node_count<Expression>::value;
+  t.split += split_bounds(ex, bounds, expected) ? 1 : 0;
+  t.runtime_ns += time(
+      [&ex, bounds] { return propagate_runtime(ex, bounds); }, t.checksum);
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  const auto bounds = [] {
+    auto b = std::vector<constraint::any_ordered>{};
+    std::apply(
+        [&b](const auto&... s) { (b.emplace_back(s.constraint()), ...); },
+        symbols);
+    return b;
+  }();
+
+  auto t = totals{};
+  [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    (run(tree<next(seed + Is), max_depth>(), bounds, t), ...);
+  }(std::make_index_sequence<tree_count>{});
+
+  const auto evaluations = static_cast<double>(t.nodes) * repetitions;
+
+  std::cout << "depth: " << max_depth << ", seed: " << seed
+            << ", trees: " << t.trees << ", nodes: " << t.nodes << "\n"
+            << "trees with bounds from different symbols: " << t.split
+            << "\n";
+  std::cout << "static: evaluated during compilation\n"
+            << "runtime: " << t.runtime_ns / evaluations << " ns/node, "
+            << evaluations / t.runtime_ns * 1e3 << " Mnodes/s\n";
+  std::cout << "mismatches: " << t.mismatches << "\n"
+            << "checksum: " << t.checksum << "\n";
+
+  return t.mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#include "sym.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace sym;
+
+// compares constraint value types on the same model: a batch of pairwise
+// `plus` constraint propagations over runtime bounds arrays
+
+namespace {
+
+constexpr auto rows = std::size_t{1} << 20U;
+constexpr auto repetitions = 32;
+
+struct model
+{
+  std::vector<constraint::any_ordered> lhs;
+  std::vector<constraint::any_ordered> rhs;
+};
+
+auto make_model() -> model
+{
+  auto rng = std::mt19937_64{};
+  auto dist = std::uniform_real_distribution<double>{-1000.0, 1000.0};
+
+  auto m = model{};
+  for (auto i = std::size_t{}; i != rows; ++i) {
+    const auto a = dist(rng);
+    const auto b = dist(rng);
+    m.lhs.emplace_back(std::min(a, b), std::max(a, b));
+
+    const auto c = dist(rng);
+    const auto d = dist(rng);
+    m.rhs.emplace_back(std::min(c, d), std::max(c, d));
+  }
+  return m;
+}
+
+template <class T>
+auto run(const char* name, const model& m) -> void
+{
+  using interval = constraint::basic_any_ordered<T>;
+
+  // outward rounding on conversion
+  auto lhs = std::vector<interval>{};
+  auto rhs = std::vector<interval>{};
+  for (auto i = std::size_t{}; i != rows; ++i) {
+    lhs.emplace_back(m.lhs[i]);
+    rhs.emplace_back(m.rhs[i]);
+  }
+
+  auto out = std::vector<interval>(rows, interval{T{}, T{}});
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto r = 0; r != repetitions; ++r) {
+    for (auto i = std::size_t{}; i != rows; ++i) {
+      out[i] = op::plus::constraint{}(lhs[i], rhs[i]);
+    }
+    std::swap(lhs, out);
+  }
+  const auto stop = std::chrono::steady_clock::now();
+
+  const auto ns = std::chrono::duration<double, std::nano>(stop - start);
+  std::cout << name << ": " << sizeof(interval) << " bytes/interval, "
+            << ns.count() / (rows * repetitions) << " ns/propagation, "
+            << "sample " << lhs[rows / 2] << "\n";
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  const auto m = make_model();
+
+  run<float>("float", m);
+  run<double>("double", m);
+  run<fixed_point<std::int32_t, 16>>("fixed_point<int32_t, 16>", m);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "detail/outward_round.hpp"
+#include "detail/print.hpp"
 #include "detail/type_name.hpp"
 
 #include <array>
@@ -44,9 +46,13 @@ class ordered_base
     requires std::is_same_v<Ordered, std::remove_cvref_t<Self>>
   friend auto operator<<(std::ostream& os, const Self& self) -> auto&
   {
+#ifdef SYM_COMPACT_CODEGEN
+    return detail::print(os, detail::describe_constraint(self));
+#else
     os << detail::type_name<typename Ordered::value_type>() << ": ["
        << self.min() << ", " << self.max() << "]";
     return os;
+#endif
   }
 };
 
@@ -69,7 +75,7 @@ public:
 
   constexpr ordered(Min min, Max max) : min_{min}, max_{max}
   {
-    assert(min_ <= max_);
+    assert(this->min() <= this->max());
   }
 
   [[nodiscard]]
@@ -84,66 +90,201 @@ public:
   }
 };
 
-/// `double` is used an an archetype to represent `Reals`
+/// numeric policy of a constraint value type
 ///
-/// This may need to be modified depending on the desired fidelity of the
-/// constraint system. This probably would not need to match the evaluation
-/// type of an expression.
+/// Defines the extreme values and the smallest positive value of `T`, used to
+/// construct the convenience constraints below. Specialize for value types
+/// that are not described by `std::numeric_limits`.
 ///
-/// @{
+template <class T>
+struct real_traits
+{
+  static_assert(std::numeric_limits<T>::is_specialized);
 
-using real_type = double;
+  using value_type = T;
 
-/// convenience value for specifying a symbol is real
-///
-inline constexpr auto real = ordered{
-    constant<-std::numeric_limits<real_type>::infinity()>{},
-    constant<+std::numeric_limits<real_type>::infinity()>{}};
+  [[nodiscard]]
+  static constexpr auto lowest() -> value_type
+  {
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+      return -std::numeric_limits<T>::infinity();
+    } else {
+      return std::numeric_limits<T>::lowest();
+    }
+  }
+  [[nodiscard]]
+  static constexpr auto highest() -> value_type
+  {
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+      return +std::numeric_limits<T>::infinity();
+    } else {
+      return std::numeric_limits<T>::max();
+    }
+  }
+  [[nodiscard]]
+  static constexpr auto smallest_positive() -> value_type
+  {
+    if constexpr (std::numeric_limits<T>::is_integer) {
+      return T{1};
+    } else {
+      return std::numeric_limits<T>::denorm_min();
+    }
+  }
+};
 
-/// convenience value for specifying a symbol is negative
+/// convenience values for specifying a symbol is real, negative, or positive
+/// with bounds of value type `T`
 ///
-inline constexpr auto negative = ordered{
-    constant<-std::numeric_limits<real_type>::infinity()>{},
-    constant<real_type{} - std::numeric_limits<real_type>::denorm_min()>{},
+/// @{
+
+template <class T>
+inline constexpr auto basic_real = ordered{
+    constant<real_traits<T>::lowest()>{},
+    constant<real_traits<T>::highest()>{}};
+
+template <class T>
+inline constexpr auto basic_negative = ordered{
+    constant<real_traits<T>::lowest()>{},
+    constant<-real_traits<T>::smallest_positive()>{},
 };
 
-/// convenience value for specifying a symbol is positive
-///
-inline constexpr auto positive = ordered{
-    constant<real_type{} + std::numeric_limits<real_type>::denorm_min()>{},
-    constant<+std::numeric_limits<real_type>::infinity()>{},
+template <class T>
+inline constexpr auto basic_positive = ordered{
+    constant<real_traits<T>::smallest_positive()>{},
+    constant<real_traits<T>::highest()>{},
 };
 
+/// @}
+
+/// `true` if `Constraint` does not constrain its value type
+///
+template <class Constraint>
+inline constexpr auto is_unconstrained_v = std::is_same_v<
+    Constraint,
+    std::remove_cvref_t<
+        decltype(basic_real<typename Constraint::value_type>)>>;
+
 /// type-erased ordered constraint
 ///
-class [[nodiscard]] any_ordered : ordered_base<any_ordered>
+/// Bounds converted from another value type are rounded outward so that the
+/// type-erased constraint always encloses the original.
+///
+template <class T>
+class [[nodiscard]] basic_any_ordered : ordered_base<basic_any_ordered<T>>
 {
-  std::array<real_type, 2> values_;
+  std::array<T, 2> values_;
 
 public:
+  using value_type = T;
+
   template <class Ordered>
-  constexpr explicit any_ordered(const Ordered& c) : values_{c.min(), c.max()}
+  constexpr explicit basic_any_ordered(const Ordered& c)
+      : values_{
+            detail::round_down<value_type>(c.min()),
+            detail::round_up<value_type>(c.max())}
   {}
 
+  constexpr basic_any_ordered(value_type min, value_type max)
+      : values_{min, max}
+  {
+    assert(min <= max);
+  }
+
   [[nodiscard]]
-  constexpr auto min() const -> real_type
+  constexpr auto min() const -> value_type
   {
     return std::get<0>(values_);
   }
   [[nodiscard]]
-  constexpr auto max() const -> real_type
+  constexpr auto max() const -> value_type
   {
     return std::get<1>(values_);
   }
 
   [[nodiscard]]
-  constexpr friend auto
-  operator==(const any_ordered& lhs, const any_ordered& rhs) -> bool
+  constexpr friend auto operator==(
+      const basic_any_ordered& lhs, const basic_any_ordered& rhs) -> bool
   {
     return lhs.min() == rhs.min() and lhs.max() == rhs.max();
   }
 };
 
+/// `true` if every value satisfying constraint `c` satisfies constraint
+/// `existing`
+///
+/// Compares bounds as `any_ordered` as the constraints may differ in value
+/// type. Overloaded for constraints that are not described by their bounds.
+///
+template <class Constraint, class Existing>
+[[nodiscard]]
+constexpr auto refines(const Constraint& c, const Existing& existing) -> bool
+{
+  const auto c1 = basic_any_ordered<double>{existing};
+  const auto c2 = basic_any_ordered<double>{c};
+  return c1.min() <= c2.min() and c1.max() >= c2.max();
+}
+
+/// `double` is used an an archetype to represent `Reals`
+///
+/// This may need to be modified depending on the desired fidelity of the
+/// constraint system. This probably would not need to match the evaluation
+/// type of an expression. Constraints with other value types (e.g. `float` or
+/// `fixed_point`) may be constructed with `basic_real`, `basic_negative`, and
+/// `basic_positive`.
+///
+/// @{
+
+using real_type = double;
+
+/// convenience value for specifying a symbol is real
+///
+inline constexpr auto real = basic_real<real_type>;
+
+/// convenience value for specifying a symbol is negative
+///
+inline constexpr auto negative = basic_negative<real_type>;
+
+/// convenience value for specifying a symbol is positive
+///
+inline constexpr auto positive = basic_positive<real_type>;
+
+/// type-erased ordered constraint
+///
+using any_ordered = basic_any_ordered<real_type>;
+
+/// @}
+
+/// value type of a constraint aggregated from constraints with value types
+/// `T1` and `T2`
+///
+/// The common type of arithmetic value types, otherwise `real_type`. Bounds
+/// are converted to the aggregate value type with `detail::round_down` and
+/// `detail::round_up`.
+///
+/// @{
+
+template <class T1, class T2>
+struct common_value_type
+{
+  using type = real_type;
+};
+
+template <class T>
+struct common_value_type<T, T>
+{
+  using type = T;
+};
+
+template <class T1, class T2>
+  requires (std::is_arithmetic_v<T1> and std::is_arithmetic_v<T2>)
+struct common_value_type<T1, T2>
+{
+  using type = std::common_type_t<T1, T2>;
+};
+
+template <class T1, class T2>
+using common_value_type_t = typename common_value_type<T1, T2>::type;
+
 /// @}
 
 }  // namespace constraint
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "detail/outward_round.hpp"
+#include "detail/static_instance.hpp"
+#include "detail/type_name.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace sym::detail {
+
+/// names of the ops defined by this library
+///
+/// Descriptors refer to these ops by index so that all expression types share
+/// a single name table.
+///
+inline constexpr auto op_names = std::array<std::string_view, 2>{
+    "sym::op::identity",
+    "sym::op::plus",
+};
+
+/// index of `Op` in `op_names`, or `op_names.size()` for other ops
+///
+template <class Op>
+consteval auto op_id() -> std::size_t
+{
+  return static_cast<std::size_t>(
+      std::ranges::find(op_names, op_name<Op>()) - op_names.begin());
+}
+
+/// constraint bound, stored exactly if it is a signed integer and otherwise
+/// as a `double` rounded outward
+///
+struct bound_descriptor
+{
+  bool is_integer{};
+  std::int64_t integer{};
+  double real{};
+};
+
+/// identity of the set of values of a constraint that is not described by
+/// its bounds
+///
+/// `nullptr` for constraints described by their bounds. Constraints with the
+/// same identity and bounds have the same values. Specialized for discrete
+/// constraints and interval unions.
+///
+template <class Constraint>
+inline constexpr const void* domain_identity = nullptr;
+
+/// compact description of a constraint
+///
+/// If `words` is not empty, the constraint is the set of integers `offset + i`
+/// for every bit `i` set in `words`. If `intervals` is not empty, the
+/// constraint is the union of the closed intervals with these lower and upper
+/// bounds. Otherwise the constraint is described by its bounds.
+///
+struct constraint_descriptor
+{
+  std::string_view value_type{};
+  bound_descriptor min{};
+  bound_descriptor max{};
+  std::int64_t offset{};
+  std::span<const std::uint64_t> words{};
+  std::span<const double> intervals{};
+  const void* domain{};
+};
+
+/// compact description of a symbol or expression type
+///
+/// Symbol names are not described, as they are generally only known at run
+/// time. Functions walking a descriptor take the names of all symbols in
+/// visitation order, as returned by `symbol_names`.
+///
+struct node_descriptor
+{
+  bool is_symbol{};
+  // index into `op_names` or `op_names.size()`
+  std::size_t op{};
+  // name of an op not in `op_names`
+  std::string_view op_name{};
+  const constraint_descriptor* constraint{};
+  std::span<const node_descriptor* const> children{};
+  // number of symbols in the described tree
+  std::size_t symbols{};
+};
+
+/// describes the bounds of a constraint
+///
+/// @{
+
+template <class T>
+[[nodiscard]]
+constexpr auto describe_min(T value) -> bound_descriptor
+{
+  if constexpr (std::signed_integral<T>) {
+    return {.is_integer = true, .integer = value};
+  } else {
+    return {.real = round_down<double>(value)};
+  }
+}
+
+template <class T>
+[[nodiscard]]
+constexpr auto describe_max(T value) -> bound_descriptor
+{
+  if constexpr (std::signed_integral<T>) {
+    return {.is_integer = true, .integer = value};
+  } else {
+    return {.real = round_up<double>(value)};
+  }
+}
+
+/// bounds of a described constraint as stored by `any_ordered`
+///
+/// @{
+
+[[nodiscard]]
+constexpr auto min_value(const constraint_descriptor& c) -> double
+{
+  return c.min.is_integer ? round_down<double>(c.min.integer) : c.min.real;
+}
+
+[[nodiscard]]
+constexpr auto max_value(const constraint_descriptor& c) -> double
+{
+  return c.max.is_integer ? round_up<double>(c.max.integer) : c.max.real;
+}
+
+/// @}
+
+template <class Constraint>
+inline constexpr auto domain_words = [] {
+  constexpr auto data = Constraint::data();
+
+  auto words = std::array<std::uint64_t, data.size>{};
+  for (auto i = std::size_t{}; i != words.size(); ++i) {
+    words[i] = data.words[i];
+  }
+  return words;
+}();
+
+/// describes a constraint value
+///
+/// Constraints with compile-time bounds are described once per type by
+/// `constraint_descriptor_v`.
+///
+template <class Constraint>
+[[nodiscard]]
+constexpr auto
+describe_constraint(const Constraint& c) -> constraint_descriptor
+{
+  auto d = constraint_descriptor{
+      type_name<typename Constraint::value_type>(),
+      describe_min(c.min()),
+      describe_max(c.max())};
+
+  if constexpr (requires { Constraint::data(); }) {
+    d.offset = Constraint::data().offset;
+    d.words = domain_words<Constraint>;
+  }
+  if constexpr (requires { Constraint::bounds(); }) {
+    d.intervals = Constraint::bounds();
+  }
+  d.domain = domain_identity<Constraint>;
+  return d;
+}
+
+template <class Constraint>
+inline constexpr auto constraint_descriptor_v =
+    describe_constraint(static_instance<Constraint>);
+
+template <class T>
+consteval auto describe_node() -> node_descriptor;
+
+/// descriptor of a symbol or expression type
+///
+template <class T>
+inline constexpr auto node_descriptor_v = describe_node<T>();
+
+template <class Args>
+inline constexpr auto child_descriptors =
+    []<class... Ts>(std::type_identity<std::tuple<Ts...>>) {
+      return std::array<const node_descriptor*, sizeof...(Ts)>{
+          &node_descriptor_v<Ts>...};
+    }(std::type_identity<Args>{});
+
+template <class T>
+consteval auto describe_node() -> node_descriptor
+{
+  const auto* constraint =
+      &constraint_descriptor_v<typename T::constraint_type>;
+
+  if constexpr (requires { typename T::op_type; }) {
+    using op_type = typename T::op_type;
+    using args_type =
+        std::remove_cvref_t<decltype(std::declval<const T&>().args())>;
+
+    constexpr auto id = op_id<op_type>();
+
+    auto symbols = std::size_t{};
+    for (const auto* child : child_descriptors<args_type>) {
+      symbols += child->symbols;
+    }
+
+    return {
+        .op = id,
+        .op_name = id == op_names.size() ? op_name<op_type>()
+                                         : std::string_view{},
+        .constraint = constraint,
+        .children = child_descriptors<args_type>,
+        .symbols = symbols};
+  } else {
+    return {.is_symbol = true, .constraint = constraint, .symbols = 1};
+  }
+}
+
+/// names of all symbols in a symbol or expression, in visitation order
+///
+template <class T>
+[[nodiscard]]
+constexpr auto symbol_names(const T& node)
+    -> std::array<std::string_view, node_descriptor_v<T>.symbols>
+{
+  if constexpr (node_descriptor_v<T>.is_symbol) {
+    return {node.name()};
+  } else {
+    return std::apply(
+        [](const auto&... args) {
+          auto names =
+              std::array<std::string_view, node_descriptor_v<T>.symbols>{};
+          auto out = names.begin();
+          const auto append = [&out](const auto& arg) {
+            out = std::ranges::copy(symbol_names(arg), out).out;
+          };
+          (append(args), ...);
+          return names;
+        },
+        node.args());
+  }
+}
+
+}  // namespace sym::detail
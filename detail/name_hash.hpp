@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace sym::detail {
+
+/// FNV-1a hash of a symbol name
+///
+[[nodiscard]]
+constexpr auto name_hash(std::string_view name) -> std::uint64_t
+{
+  auto h = std::uint64_t{14695981039346656037U};
+  for (const auto c : name) {
+    h ^= static_cast<unsigned char>(c);
+    h *= std::uint64_t{1099511628211U};
+  }
+  return h;
+}
+
+}  // namespace sym::detail
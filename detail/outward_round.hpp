@@ -0,0 +1,196 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace sym::detail {
+
+/// next representable value towards negative infinity
+///
+template <std::floating_point T>
+  requires (std::numeric_limits<T>::is_iec559)
+[[nodiscard]]
+constexpr auto next_down(T x) -> T
+{
+  using bits_type = std::conditional_t<
+      sizeof(T) == sizeof(std::uint32_t),
+      std::uint32_t,
+      std::uint64_t>;
+  static_assert(sizeof(T) == sizeof(bits_type));
+
+  if (x != x or x == -std::numeric_limits<T>::infinity()) {
+    return x;
+  }
+  if (x == T{}) {
+    return -std::numeric_limits<T>::denorm_min();
+  }
+
+  const auto bits = std::bit_cast<bits_type>(x);
+  return std::bit_cast<T>(x > T{} ? bits - 1U : bits + 1U);
+}
+
+/// next representable value towards positive infinity
+///
+template <std::floating_point T>
+[[nodiscard]]
+constexpr auto next_up(T x) -> T
+{
+  return -next_down(-x);
+}
+
+/// `true` if `x` is neither infinite nor NaN
+///
+template <std::floating_point T>
+[[nodiscard]]
+constexpr auto is_finite(T x) -> bool
+{
+  return -std::numeric_limits<T>::max() <= x and
+         x <= std::numeric_limits<T>::max();
+}
+
+/// direction in which the sum of two finite values overflows, or `0`
+///
+/// Halving is exact for values large enough to overflow, so the halved sum
+/// exceeds half the greatest finite value exactly when `a + b` overflows. The
+/// sum itself is not computed, as overflow is not a constant expression.
+///
+template <std::floating_point T>
+[[nodiscard]]
+constexpr auto overflows(T a, T b) -> int
+{
+  if (not is_finite(a) or not is_finite(b)) {
+    return 0;
+  }
+
+  constexpr auto max = std::numeric_limits<T>::max();
+  const auto half = (a / 2) + (b / 2);
+  return half > max / 2 ? 1 : half < -max / 2 ? -1 : 0;
+}
+
+/// sum of two values, rounding toward negative or positive infinity
+///
+/// The rounding error of `a + b` is computed exactly (Knuth's TwoSum) and the
+/// rounded sum is moved by one ulp if it lies on the wrong side of the exact
+/// sum. A sum of finite values that overflows is rounded to the nearest
+/// finite value in the rounding direction or to the infinity beyond it.
+///
+/// @{
+
+template <std::floating_point T>
+[[nodiscard]]
+constexpr auto add_down(T a, T b) -> T
+{
+  if (const auto direction = overflows(a, b); direction != 0) {
+    return direction > 0 ? std::numeric_limits<T>::max()
+                         : -std::numeric_limits<T>::infinity();
+  }
+  const auto s = a + b;
+  if (not is_finite(s)) {
+    return s;
+  }
+  const auto bb = s - a;
+  const auto error = (a - (s - bb)) + (b - bb);
+  return error < T{} ? next_down(s) : s;
+}
+
+template <std::floating_point T>
+[[nodiscard]]
+constexpr auto add_up(T a, T b) -> T
+{
+  if (const auto direction = overflows(a, b); direction != 0) {
+    return direction > 0 ? std::numeric_limits<T>::infinity()
+                         : std::numeric_limits<T>::lowest();
+  }
+  const auto s = a + b;
+  if (not is_finite(s)) {
+    return s;
+  }
+  const auto bb = s - a;
+  const auto error = (a - (s - bb)) + (b - bb);
+  return error > T{} ? next_up(s) : s;
+}
+
+/// @}
+
+/// conversion of a value to another value type, rounding outward
+///
+/// `round_down` returns the greatest `To` not greater than `x` and `round_up`
+/// returns the least `To` not less than `x`. This is used when converting
+/// constraint bounds so that a converted interval always encloses the
+/// original one.
+///
+/// Integral values may be converted to floating-point or to an integral type
+/// that represents them. Other
+/// non-floating-point value types must be explicitly convertible to `double`
+/// without loss and must provide `To::floor(double)` and `To::ceil(double)`.
+///
+/// @{
+
+template <class To, class From>
+[[nodiscard]]
+constexpr auto round_down(From x) -> To
+{
+  if constexpr (std::is_same_v<To, From>) {
+    return x;
+  } else if constexpr (std::is_integral_v<From> and std::is_integral_v<To>) {
+    assert(std::in_range<To>(x) and "integral value must be representable");
+    return static_cast<To>(x);
+  } else if constexpr (std::is_integral_v<From>) {
+    static_assert(std::is_floating_point_v<To>);
+    const auto y = static_cast<To>(x);
+    // `y` may be rounded past the greatest `From`
+    if constexpr (
+        std::numeric_limits<From>::digits > std::numeric_limits<To>::digits) {
+      if (y >= static_cast<To>(std::numeric_limits<From>::max())) {
+        return next_down(y);
+      }
+    }
+    return static_cast<From>(y) > x ? next_down(y) : y;
+  } else if constexpr (not std::is_floating_point_v<From>) {
+    return round_down<To>(static_cast<double>(x));
+  } else if constexpr (not std::is_floating_point_v<To>) {
+    return To::floor(static_cast<double>(x));
+  } else {
+    const auto y = static_cast<To>(x);
+    return static_cast<From>(y) > x ? next_down(y) : y;
+  }
+}
+
+template <class To, class From>
+[[nodiscard]]
+constexpr auto round_up(From x) -> To
+{
+  if constexpr (std::is_same_v<To, From>) {
+    return x;
+  } else if constexpr (std::is_integral_v<From> and std::is_integral_v<To>) {
+    assert(std::in_range<To>(x) and "integral value must be representable");
+    return static_cast<To>(x);
+  } else if constexpr (std::is_integral_v<From>) {
+    static_assert(std::is_floating_point_v<To>);
+    const auto y = static_cast<To>(x);
+    // `y` may be rounded past the greatest `From`
+    if constexpr (
+        std::numeric_limits<From>::digits > std::numeric_limits<To>::digits) {
+      if (y >= static_cast<To>(std::numeric_limits<From>::max())) {
+        return y;
+      }
+    }
+    return static_cast<From>(y) < x ? next_up(y) : y;
+  } else if constexpr (not std::is_floating_point_v<From>) {
+    return round_up<To>(static_cast<double>(x));
+  } else if constexpr (not std::is_floating_point_v<To>) {
+    return To::ceil(static_cast<double>(x));
+  } else {
+    const auto y = static_cast<To>(x);
+    return static_cast<From>(y) < x ? next_up(y) : y;
+  }
+}
+
+/// @}
+
+}  // namespace sym::detail
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "detail/descriptor.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace sym::detail {
+
+/// printing cores shared by all symbol, expression, and constraint types
+///
+/// Used instead of per-type formatting when `SYM_COMPACT_CODEGEN` is defined.
+/// Output is the same as that of the per-type formatting.
+///
+/// @{
+
+inline auto print(std::ostream& os, const bound_descriptor& b) -> std::ostream&
+{
+  if (b.is_integer) {
+    os << b.integer;
+  } else {
+    os << b.real;
+  }
+  return os;
+}
+
+inline auto
+print(std::ostream& os, const constraint_descriptor& c) -> std::ostream&
+{
+  os << c.value_type << ": ";
+
+  if (c.words.empty() and c.intervals.empty()) {
+    os << "[";
+    print(os, c.min) << ", ";
+    print(os, c.max) << "]";
+    return os;
+  }
+
+  if (not c.intervals.empty()) {
+    os << "{";
+    auto separator = "";
+    for (auto i = std::size_t{}; i != c.intervals.size(); i += 2) {
+      os << std::exchange(separator, ", ");
+      if (c.intervals[i] == c.intervals[i + 1]) {
+        os << c.intervals[i];
+      } else {
+        os << "[" << c.intervals[i] << ", " << c.intervals[i + 1] << "]";
+      }
+    }
+    os << "}";
+    return os;
+  }
+
+  const auto contains = [&c](std::int64_t v) {
+    constexpr auto word_bits = std::size_t{64};
+    const auto bit = static_cast<std::size_t>(v - c.offset);
+    return ((c.words[bit / word_bits] >> (bit % word_bits)) & 1U) != 0;
+  };
+
+  os << "{";
+  auto separator = "";
+  for (auto v = c.min.integer; v <= c.max.integer; ++v) {
+    if (not contains(v)) {
+      continue;
+    }
+    auto last = v;
+    while (last != c.max.integer and contains(last + 1)) {
+      ++last;
+    }
+
+    os << std::exchange(separator, ", ") << v;
+    if (last != v) {
+      os << ".." << last;
+    }
+    v = last;
+  }
+  os << "}";
+  return os;
+}
+
+inline auto print_node(
+    std::ostream& os,
+    const node_descriptor& node,
+    const std::string_view*& name) -> std::ostream&
+{
+  if (node.is_symbol) {
+    os << "symbol(" << *name++ << ") [";
+    print(os, *node.constraint) << "]";
+    return os;
+  }
+
+  os << "expression { "
+     << (node.op == op_names.size() ? node.op_name : op_names[node.op]);
+  for (const auto* child : node.children) {
+    print_node(os << ", ", *child, name);
+  }
+  os << " } ";
+  print(os, *node.constraint);
+  return os;
+}
+
+/// prints the symbol or expression described by `node`
+///
+/// `names` are the names of all symbols in `node`, in visitation order.
+///
+inline auto print(
+    std::ostream& os,
+    const node_descriptor& node,
+    std::span<const std::string_view> names) -> std::ostream&
+{
+  assert(names.size() == node.symbols and "one name is required per symbol");
+
+  const auto* name = names.data();
+  return print_node(os, node, name);
+}
+
+/// @}
+
+}  // namespace sym::detail
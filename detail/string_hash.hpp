@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace sym::detail {
+
+/// transparent hash for unordered containers keyed by strings
+///
+struct string_hash
+{
+  using is_transparent = void;
+
+  [[nodiscard]]
+  auto operator()(std::string_view s) const -> std::size_t
+  {
+    return std::hash<std::string_view>{}(s);
+  }
+};
+
+}  // namespace sym::detail
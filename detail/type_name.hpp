@@ -55,4 +55,19 @@ consteval auto type_name() -> std::string_view
   return wrapped_name.substr(prefix_length, type_name_length);
 }
 
+/// name of an operation
+///
+/// Uses `Op::name` if defined. This avoids emitting the full
+/// `std::source_location::function_name()` string used by `type_name`.
+///
+template <class Op>
+consteval auto op_name() -> std::string_view
+{
+  if constexpr (requires { std::string_view{Op::name}; }) {
+    return Op::name;
+  } else {
+    return type_name<Op>();
+  }
+}
+
 }  // namespace sym::detail
@@ -0,0 +1,1055 @@
+#pragma once
+
+#include "constraint.hpp"
+#include "detail/descriptor.hpp"
+#include "detail/outward_round.hpp"
+#include "detail/print.hpp"
+#include "detail/static_instance.hpp"
+#include "detail/type_name.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace sym {
+namespace constraint {
+
+/// value type of discrete constraints
+///
+using integer_type = std::int64_t;
+
+/// convenience value for specifying a symbol is an integer in [Min, Max]
+///
+template <integer_type Min, integer_type Max>
+inline constexpr auto integer_range = ordered{constant<Min>{}, constant<Max>{}};
+
+}  // namespace constraint
+
+namespace detail {
+
+using constraint::integer_type;
+
+inline constexpr auto word_bits = integer_type{64};
+
+/// maximum number of words in a small domain
+///
+inline constexpr auto max_words = std::size_t{64};
+
+[[nodiscard]]
+constexpr auto floor_div(integer_type a, integer_type b) -> integer_type
+{
+  return (a / b) - ((a % b != 0) and (a < 0) ? 1 : 0);
+}
+
+/// bitset over a word aligned range of integers
+///
+/// Used during constant evaluation to compute `bitset_domain` types. A
+/// normalized bitset has non-zero first and last words.
+///
+struct bitset_data
+{
+  integer_type offset{};
+  std::size_t size{};
+  std::array<std::uint64_t, max_words> words{};
+
+  [[nodiscard]]
+  constexpr auto word(integer_type word_offset) const -> std::uint64_t
+  {
+    const auto i = floor_div(word_offset - offset, word_bits);
+    return (i < 0 or i >= static_cast<integer_type>(size))
+               ? std::uint64_t{}
+               : words[static_cast<std::size_t>(i)];
+  }
+
+  [[nodiscard]]
+  constexpr auto normalized() const -> bitset_data
+  {
+    auto first = std::size_t{};
+    while (first != size and words[first] == 0) {
+      ++first;
+    }
+    auto last = size;
+    while (last != first and words[last - 1] == 0) {
+      --last;
+    }
+
+    assert(first != last and "discrete constraint must be non-empty");
+
+    auto b = bitset_data{
+        offset + (static_cast<integer_type>(first) * word_bits),
+        last - first};
+    for (auto i = std::size_t{}; i != b.size; ++i) {
+      b.words[i] = words[first + i];
+    }
+    return b;
+  }
+};
+
+[[nodiscard]]
+consteval auto
+make_range_bitset(integer_type lo, integer_type hi) -> bitset_data
+{
+  assert(lo <= hi);
+
+  const auto offset = floor_div(lo, word_bits) * word_bits;
+  const auto words = floor_div(hi - offset, word_bits) + 1;
+
+  assert(words <= static_cast<integer_type>(max_words) and
+         "integer range is too large for a small domain");
+
+  auto b = bitset_data{offset, static_cast<std::size_t>(words)};
+  for (auto v = lo; v <= hi; ++v) {
+    const auto bit = v - offset;
+    b.words[static_cast<std::size_t>(bit / word_bits)] |= std::uint64_t{1}
+                                                          << (bit % word_bits);
+  }
+  return b;
+}
+
+/// word-parallel set operations
+///
+/// @{
+
+template <class F>
+[[nodiscard]]
+consteval auto
+combine(const bitset_data& a, const bitset_data& b, F f) -> bitset_data
+{
+  const auto offset = std::min(a.offset, b.offset);
+  const auto end = std::max(
+      a.offset + (static_cast<integer_type>(a.size) * word_bits),
+      b.offset + (static_cast<integer_type>(b.size) * word_bits));
+  const auto words = (end - offset) / word_bits;
+
+  assert(words <= static_cast<integer_type>(max_words) and
+         "discrete constraint is too large for a small domain");
+
+  auto c = bitset_data{offset, static_cast<std::size_t>(words)};
+  for (auto i = std::size_t{}; i != c.size; ++i) {
+    const auto w = offset + (static_cast<integer_type>(i) * word_bits);
+    c.words[i] = f(a.word(w), b.word(w));
+  }
+  return c.normalized();
+}
+
+[[nodiscard]]
+consteval auto unite(const bitset_data& a, const bitset_data& b) -> bitset_data
+{
+  return combine(a, b, [](auto x, auto y) { return x | y; });
+}
+
+[[nodiscard]]
+consteval auto
+intersect(const bitset_data& a, const bitset_data& b) -> bitset_data
+{
+  return combine(a, b, [](auto x, auto y) { return x & y; });
+}
+
+/// `true` if every element of `a` is an element of `b`
+///
+[[nodiscard]]
+constexpr auto is_subset(const bitset_data& a, const bitset_data& b) -> bool
+{
+  for (auto i = std::size_t{}; i != a.size; ++i) {
+    const auto x = a.words[i];
+    if ((x & b.word(a.offset + (static_cast<integer_type>(i) * word_bits))) !=
+        x) {
+      return false;
+    }
+  }
+  return true;
+}
+
+[[nodiscard]]
+consteval auto
+make_values_bitset(std::initializer_list<integer_type> values) -> bitset_data
+{
+  auto b = make_range_bitset(std::min(values), std::max(values));
+  b.words = {};
+  for (const auto v : values) {
+    const auto bit = v - b.offset;
+    b.words[static_cast<std::size_t>(bit / word_bits)] |= std::uint64_t{1}
+                                                          << (bit % word_bits);
+  }
+  return b;
+}
+
+/// @}
+
+/// `true` if the integers in [lo, hi] can be stored in a small domain
+///
+[[nodiscard]]
+constexpr auto fits_words(integer_type lo, integer_type hi) -> bool
+{
+  // computed modulo 2^64 to avoid overflow
+  const auto difference =
+      static_cast<std::uint64_t>(hi) - static_cast<std::uint64_t>(lo);
+  if (lo > hi or difference >= max_words * word_bits) {
+    return false;
+  }
+  const auto offset = floor_div(lo, word_bits) * word_bits;
+  return floor_div(hi - offset, word_bits) + 1 <=
+         static_cast<integer_type>(max_words);
+}
+
+using constraint::real_type;
+
+/// `true` if `x` is an integer that can be represented as `integer_type`
+///
+[[nodiscard]]
+constexpr auto is_integer(real_type x) -> bool
+{
+  return x >= -0x1p63 and x < 0x1p63 and
+         static_cast<real_type>(static_cast<integer_type>(x)) == x;
+}
+
+/// maximum number of intervals in an interval union
+///
+inline constexpr auto max_intervals = std::size_t{64};
+
+/// sorted disjoint closed real intervals
+///
+/// Used during constant evaluation to compute `interval_union` types.
+/// Intervals are appended in increasing order and overlapping or touching
+/// intervals are merged so that every set has exactly one representation.
+///
+struct interval_data
+{
+  std::size_t size{};
+  std::array<real_type, 2 * max_intervals> bounds{};
+
+  [[nodiscard]]
+  constexpr auto min(std::size_t i) const -> real_type
+  {
+    return bounds[2 * i];
+  }
+  [[nodiscard]]
+  constexpr auto max(std::size_t i) const -> real_type
+  {
+    return bounds[(2 * i) + 1];
+  }
+
+  constexpr auto push_back(real_type lo, real_type hi) -> void
+  {
+    assert(lo <= hi);
+
+    // `-0.0` and `0.0` are different template arguments
+    lo = lo == real_type{} ? real_type{} : lo;
+    hi = hi == real_type{} ? real_type{} : hi;
+
+    if (size != 0 and lo <= max(size - 1)) {
+      bounds[(2 * size) - 1] = std::max(max(size - 1), hi);
+      return;
+    }
+
+    assert(
+        size != max_intervals and "too many intervals for an interval union");
+    bounds[2 * size] = lo;
+    bounds[(2 * size) + 1] = hi;
+    ++size;
+  }
+
+  /// `true` if [lo, hi] is a subset of a single interval
+  ///
+  [[nodiscard]]
+  constexpr auto encloses(real_type lo, real_type hi) const -> bool
+  {
+    for (auto i = std::size_t{}; i != size; ++i) {
+      if (min(i) <= lo and hi <= max(i)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// `true` if every interval is a single integer that can be stored in a
+  /// small domain
+  ///
+  [[nodiscard]]
+  constexpr auto is_discrete() const -> bool
+  {
+    for (auto i = std::size_t{}; i != size; ++i) {
+      if (min(i) != max(i) or not is_integer(min(i))) {
+        return false;
+      }
+    }
+    return fits_words(
+        static_cast<integer_type>(min(0)),
+        static_cast<integer_type>(max(size - 1)));
+  }
+};
+
+/// set operations on intervals
+///
+/// @{
+
+[[nodiscard]]
+consteval auto
+unite(const interval_data& a, const interval_data& b) -> interval_data
+{
+  auto c = interval_data{};
+  auto i = std::size_t{};
+  auto j = std::size_t{};
+  while (i != a.size or j != b.size) {
+    if (j == b.size or (i != a.size and a.min(i) <= b.min(j))) {
+      c.push_back(a.min(i), a.max(i));
+      ++i;
+    } else {
+      c.push_back(b.min(j), b.max(j));
+      ++j;
+    }
+  }
+  return c;
+}
+
+[[nodiscard]]
+consteval auto
+intersect(const interval_data& a, const interval_data& b) -> interval_data
+{
+  auto c = interval_data{};
+  auto i = std::size_t{};
+  auto j = std::size_t{};
+  while (i != a.size and j != b.size) {
+    const auto lo = std::max(a.min(i), b.min(j));
+    const auto hi = std::min(a.max(i), b.max(j));
+    if (lo <= hi) {
+      c.push_back(lo, hi);
+    }
+    if (a.max(i) < b.max(j)) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+
+  assert(c.size != 0 and "constraint must be non-empty");
+  return c;
+}
+
+/// @}
+
+/// conversions between the elements of a small domain and intervals
+///
+/// @{
+
+[[nodiscard]]
+consteval auto to_intervals(const bitset_data& b) -> interval_data
+{
+  auto c = interval_data{};
+  for (auto i = std::size_t{}; i != b.size; ++i) {
+    for (auto bit = 0; bit != word_bits; ++bit) {
+      if (((b.words[i] >> bit) & 1U) != 0) {
+        const auto v =
+            b.offset + (static_cast<integer_type>(i) * word_bits) + bit;
+        c.push_back(round_down<real_type>(v), round_up<real_type>(v));
+      }
+    }
+  }
+  return c;
+}
+
+/// elements of intervals for which `is_discrete()` is `true`
+///
+[[nodiscard]]
+consteval auto to_bitset(const interval_data& c) -> bitset_data
+{
+  auto b = make_range_bitset(
+      static_cast<integer_type>(c.min(0)),
+      static_cast<integer_type>(c.max(c.size - 1)));
+  b.words = {};
+  for (auto i = std::size_t{}; i != c.size; ++i) {
+    const auto bit = static_cast<integer_type>(c.min(i)) - b.offset;
+    b.words[static_cast<std::size_t>(bit / word_bits)] |= std::uint64_t{1}
+                                                          << (bit % word_bits);
+  }
+  return b;
+}
+
+/// @}
+
+}  // namespace detail
+
+namespace constraint {
+
+/// constraint describing a small set of integers
+///
+/// The set is stored as a bitset in the type. `Offset` is a multiple of 64 and
+/// the first and last words are non-zero so that every set has exactly one
+/// representation.
+///
+/// Construct with `one_of` or by combining integer ranges and other small
+/// domains with `|` (union) and `&` (intersection):
+///
+/// ~~~{.cpp}
+/// // {0, 2, 5..9}
+/// constexpr auto d = integer_range<0, 0> | integer_range<2, 2> |
+///                    integer_range<5, 9>;
+/// ~~~
+///
+template <integer_type Offset, std::uint64_t... Words>
+  requires (
+      Offset % detail::word_bits == 0 and sizeof...(Words) != 0 and
+      sizeof...(Words) <= detail::max_words and
+      std::array{Words...}.front() != 0 and std::array{Words...}.back() != 0)
+class [[nodiscard]] bitset_domain
+{
+  static constexpr auto words_ = std::array{Words...};
+
+public:
+  using value_type = integer_type;
+
+  [[nodiscard]]
+  static consteval auto data() -> detail::bitset_data
+  {
+    auto b = detail::bitset_data{Offset, words_.size()};
+    for (auto i = std::size_t{}; i != words_.size(); ++i) {
+      b.words[i] = words_[i];
+    }
+    return b;
+  }
+
+  [[nodiscard]]
+  constexpr auto contains(value_type v) const -> bool
+  {
+    if (v < Offset or v >= Offset + (static_cast<value_type>(words_.size()) *
+                                     detail::word_bits)) {
+      return false;
+    }
+    const auto bit = v - Offset;
+    return ((words_[static_cast<std::size_t>(bit / detail::word_bits)] >>
+             (bit % detail::word_bits)) &
+            1U) != 0;
+  }
+
+  /// number of elements in the set
+  ///
+  [[nodiscard]]
+  constexpr auto size() const -> std::size_t
+  {
+    return (static_cast<std::size_t>(std::popcount(Words)) + ...);
+  }
+
+  [[nodiscard]]
+  constexpr auto min() const -> value_type
+  {
+    return Offset + std::countr_zero(words_.front());
+  }
+  [[nodiscard]]
+  constexpr auto max() const -> value_type
+  {
+    return Offset +
+           (static_cast<value_type>(words_.size()) * detail::word_bits) - 1 -
+           std::countl_zero(words_.back());
+  }
+
+  /// prints the set as a list of values and closed ranges
+  ///
+  friend auto operator<<(std::ostream& os, const bitset_domain& d) -> auto&
+  {
+#ifdef SYM_COMPACT_CODEGEN
+    return detail::print(os, detail::describe_constraint(d));
+#else
+    os << detail::type_name<value_type>() << ": {";
+
+    auto separator = "";
+    for (auto v = d.min(); v <= d.max(); ++v) {
+      if (not d.contains(v)) {
+        continue;
+      }
+      auto last = v;
+      while (last != d.max() and d.contains(last + 1)) {
+        ++last;
+      }
+
+      os << std::exchange(separator, ", ") << v;
+      if (last != v) {
+        os << ".." << last;
+      }
+      v = last;
+    }
+
+    os << "}";
+    return os;
+#endif
+  }
+};
+
+template <class T>
+struct is_bitset_domain : std::false_type
+{};
+
+template <integer_type Offset, std::uint64_t... Words>
+struct is_bitset_domain<bitset_domain<Offset, Words...>> : std::true_type
+{};
+
+template <class T>
+inline constexpr auto is_bitset_domain_v = is_bitset_domain<T>::value;
+
+}  // namespace constraint
+
+namespace detail {
+
+/// `true` if `bounds` are the bounds of the intervals of an `interval_union`
+///
+template <std::size_t N>
+[[nodiscard]]
+consteval auto
+is_interval_union_bounds(const std::array<real_type, N>& bounds) -> bool
+{
+  if (N % 2 != 0 or N < 4 or N > 2 * max_intervals) {
+    return false;
+  }
+  for (auto i = std::size_t{}; i != N; ++i) {
+    if (std::bit_cast<std::uint64_t>(bounds[i]) ==
+        std::bit_cast<std::uint64_t>(-real_type{})) {
+      return false;
+    }
+    // bounds of an interval may be equal, intervals are separated by gaps
+    if (i != 0 and (i % 2 == 1 ? not(bounds[i - 1] <= bounds[i])
+                               : not(bounds[i - 1] < bounds[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace detail
+
+namespace constraint {
+
+/// constraint describing a union of disjoint closed real intervals
+///
+/// `Bounds` are the lower and upper bound of each interval, in increasing
+/// order. There are at least two intervals, separated by gaps, so that every
+/// set has exactly one representation. A single value is an interval with
+/// equal bounds.
+///
+/// Construct by combining ordered constraints, small domains, and other
+/// interval unions with `|` (union) and `&` (intersection). A combination that
+/// is a single interval is an `ordered` constraint and a combination of
+/// integers is a `bitset_domain`:
+///
+/// ~~~{.cpp}
+/// // {-1, [0.5, 0.7], 2}
+/// constexpr auto d =
+///     one_of<-1, 2> | ordered{constant<0.5>{}, constant<0.7>{}};
+/// ~~~
+///
+template <real_type... Bounds>
+  requires (detail::is_interval_union_bounds(std::array{Bounds...}))
+class [[nodiscard]] interval_union
+{
+  static constexpr auto bounds_ = std::array{Bounds...};
+
+public:
+  using value_type = real_type;
+
+  /// lower and upper bound of each interval
+  ///
+  [[nodiscard]]
+  static constexpr auto
+  bounds() -> std::span<const value_type, sizeof...(Bounds)>
+  {
+    return bounds_;
+  }
+
+  [[nodiscard]]
+  static consteval auto intervals() -> detail::interval_data
+  {
+    auto c = detail::interval_data{};
+    for (auto i = std::size_t{}; i != bounds_.size(); i += 2) {
+      c.push_back(bounds_[i], bounds_[i + 1]);
+    }
+    return c;
+  }
+
+  [[nodiscard]]
+  constexpr auto contains(value_type v) const -> bool
+  {
+    for (auto i = std::size_t{}; i != bounds_.size(); i += 2) {
+      if (bounds_[i] <= v and v <= bounds_[i + 1]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// number of intervals
+  ///
+  [[nodiscard]]
+  constexpr auto size() const -> std::size_t
+  {
+    return bounds_.size() / 2;
+  }
+
+  [[nodiscard]]
+  constexpr auto min() const -> value_type
+  {
+    return bounds_.front();
+  }
+  [[nodiscard]]
+  constexpr auto max() const -> value_type
+  {
+    return bounds_.back();
+  }
+
+  /// prints the set as a list of values and closed intervals
+  ///
+  friend auto operator<<(std::ostream& os, const interval_union& u) -> auto&
+  {
+#ifdef SYM_COMPACT_CODEGEN
+    return detail::print(os, detail::describe_constraint(u));
+#else
+    os << detail::type_name<value_type>() << ": {";
+
+    const auto b = u.bounds();
+    auto separator = "";
+    for (auto i = std::size_t{}; i != b.size(); i += 2) {
+      os << std::exchange(separator, ", ");
+      if (b[i] == b[i + 1]) {
+        os << b[i];
+      } else {
+        os << "[" << b[i] << ", " << b[i + 1] << "]";
+      }
+    }
+
+    os << "}";
+    return os;
+#endif
+  }
+};
+
+template <class T>
+struct is_interval_union : std::false_type
+{};
+
+template <real_type... Bounds>
+struct is_interval_union<interval_union<Bounds...>> : std::true_type
+{};
+
+template <class T>
+inline constexpr auto is_interval_union_v = is_interval_union<T>::value;
+
+}  // namespace constraint
+
+namespace detail {
+
+template <class Bits, std::size_t... Is>
+auto to_bitset_domain(std::index_sequence<Is...>) -> constraint::
+    bitset_domain<Bits::value().offset, Bits::value().words[Is]...>;
+
+/// small domain type with the elements of normalized bitset `Bits::value()`
+///
+template <class Bits>
+using to_bitset_domain_t = decltype(to_bitset_domain<Bits>(
+    std::make_index_sequence<Bits::value().size>{}));
+
+/// bitset representation of a discrete constraint
+///
+/// @{
+
+template <class Constraint>
+struct bits_of
+{};
+
+template <integer_type Offset, std::uint64_t... Words>
+struct bits_of<constraint::bitset_domain<Offset, Words...>>
+{
+  [[nodiscard]]
+  static consteval auto value() -> bitset_data
+  {
+    return constraint::bitset_domain<Offset, Words...>::data();
+  }
+};
+
+template <std::integral auto Min, std::integral auto Max>
+struct bits_of<constraint::ordered<constant<Min>, constant<Max>>>
+{
+  [[nodiscard]]
+  static consteval auto value() -> bitset_data
+  {
+    return make_range_bitset(
+        static_cast<integer_type>(Min), static_cast<integer_type>(Max));
+  }
+};
+
+/// @}
+
+/// bitsets computed from discrete constraints
+///
+/// @{
+
+template <class C1, class C2>
+struct union_bits
+{
+  [[nodiscard]]
+  static consteval auto value() -> bitset_data
+  {
+    return unite(bits_of<C1>::value(), bits_of<C2>::value());
+  }
+};
+
+template <class C1, class C2>
+struct intersection_bits
+{
+  [[nodiscard]]
+  static consteval auto value() -> bitset_data
+  {
+    return intersect(bits_of<C1>::value(), bits_of<C2>::value());
+  }
+};
+
+template <integer_type... Values>
+struct values_bits
+{
+  [[nodiscard]]
+  static consteval auto value() -> bitset_data
+  {
+    return make_values_bitset({Values...});
+  }
+};
+
+/// @}
+
+}  // namespace detail
+
+namespace constraint {
+
+/// constraint with a finite set of integer values
+///
+/// Either a `bitset_domain` or an integer `ordered` constraint. Integer ranges
+/// must be small enough to be represented as a `bitset_domain` when combined
+/// with one.
+///
+template <class Constraint>
+concept discrete = requires { detail::bits_of<Constraint>::value(); };
+
+}  // namespace constraint
+
+namespace detail {
+
+/// `true` if a discrete constraint can be represented as a `bitset_domain`
+///
+template <constraint::discrete Constraint>
+inline constexpr auto is_small_v = [] {
+  if constexpr (constraint::is_bitset_domain_v<Constraint>) {
+    return true;
+  } else {
+    return fits_words(
+        static_cast<integer_type>(Constraint{}.min()),
+        static_cast<integer_type>(Constraint{}.max()));
+  }
+}();
+
+/// interval representation of a constraint with compile-time bounds
+///
+/// @{
+
+template <class Constraint>
+struct intervals_of
+{};
+
+template <auto Min, auto Max>
+  requires (not(std::integral<decltype(Min)> and std::integral<decltype(Max)>))
+struct intervals_of<constraint::ordered<constant<Min>, constant<Max>>>
+{
+  [[nodiscard]]
+  static consteval auto value() -> interval_data
+  {
+    auto c = interval_data{};
+    c.push_back(round_down<real_type>(Min), round_up<real_type>(Max));
+    return c;
+  }
+};
+
+template <constraint::discrete Constraint>
+  requires (is_small_v<Constraint>)
+struct intervals_of<Constraint>
+{
+  [[nodiscard]]
+  static consteval auto value() -> interval_data
+  {
+    return to_intervals(bits_of<Constraint>::value());
+  }
+};
+
+template <real_type... Bounds>
+struct intervals_of<constraint::interval_union<Bounds...>>
+{
+  [[nodiscard]]
+  static consteval auto value() -> interval_data
+  {
+    return constraint::interval_union<Bounds...>::intervals();
+  }
+};
+
+/// @}
+
+/// intervals computed from constraints
+///
+/// @{
+
+template <class C1, class C2>
+struct union_intervals
+{
+  [[nodiscard]]
+  static consteval auto value() -> interval_data
+  {
+    return unite(intervals_of<C1>::value(), intervals_of<C2>::value());
+  }
+};
+
+template <class C1, class C2>
+struct intersection_intervals
+{
+  [[nodiscard]]
+  static consteval auto value() -> interval_data
+  {
+    return intersect(intervals_of<C1>::value(), intervals_of<C2>::value());
+  }
+};
+
+template <class Intervals>
+struct discrete_interval_bits
+{
+  [[nodiscard]]
+  static consteval auto value() -> bitset_data
+  {
+    return to_bitset(Intervals::value());
+  }
+};
+
+/// @}
+
+template <class Intervals, std::size_t... Is>
+auto to_interval_union(std::index_sequence<Is...>)
+    -> constraint::interval_union<Intervals::value().bounds[Is]...>;
+
+template <class Intervals>
+consteval auto to_interval_domain()
+{
+  constexpr auto c = Intervals::value();
+
+  if constexpr (c.is_discrete()) {
+    return std::type_identity<
+        to_bitset_domain_t<discrete_interval_bits<Intervals>>>{};
+  } else if constexpr (c.size == 1) {
+    return std::type_identity<
+        constraint::ordered<constant<c.min(0)>, constant<c.max(0)>>>{};
+  } else {
+    return std::type_identity<decltype(to_interval_union<Intervals>(
+        std::make_index_sequence<2 * c.size>{}))>{};
+  }
+}
+
+/// constraint type with the elements of intervals `Intervals::value()`
+///
+/// A `bitset_domain` if every element is an integer, otherwise an `ordered`
+/// constraint if there is a single interval and an `interval_union` if there
+/// are more.
+///
+template <class Intervals>
+using to_interval_domain_t =
+    typename decltype(to_interval_domain<Intervals>())::type;
+
+/// identity of integer ranges too large for a small domain
+///
+/// These ranges are described by their bounds.
+///
+inline constexpr auto large_integer_range = char{};
+
+/// discrete constraints with the same elements have the identity of the
+/// same small domain type
+///
+template <constraint::discrete Constraint>
+inline constexpr const void* domain_identity<Constraint> =
+    []() -> const void* {
+  if constexpr (is_small_v<Constraint>) {
+    return &static_instance<to_bitset_domain_t<bits_of<Constraint>>>;
+  } else {
+    return &large_integer_range;
+  }
+}();
+
+template <real_type... Bounds>
+inline constexpr const void*
+    domain_identity<constraint::interval_union<Bounds...>> =
+        &static_instance<constraint::interval_union<Bounds...>>;
+
+}  // namespace detail
+
+namespace constraint {
+
+/// constraint that is a union of intervals with compile-time bounds
+///
+/// An ordered constraint with compile-time bounds, a discrete constraint that
+/// can be represented as a small domain, or an `interval_union`.
+///
+template <class Constraint>
+concept interval_set = requires { detail::intervals_of<Constraint>::value(); };
+
+/// convenience value for specifying a symbol is one of `Values...`
+///
+template <integer_type... Values>
+  requires (sizeof...(Values) != 0)
+inline constexpr auto one_of =
+    detail::to_bitset_domain_t<detail::values_bits<Values...>>{};
+
+/// union and intersection of constraints
+///
+/// The union and intersection of discrete constraints are computed with
+/// word-parallel bitset operations. Otherwise, the result is computed from
+/// the intervals of each constraint and is an `interval_union` if it is not a
+/// single interval or a set of integers.
+///
+/// @{
+
+template <discrete C1, discrete C2>
+[[nodiscard]]
+constexpr auto operator|(C1, C2)
+    -> detail::to_bitset_domain_t<detail::union_bits<C1, C2>>
+{
+  return {};
+}
+
+template <discrete C1, discrete C2>
+[[nodiscard]]
+constexpr auto operator&(C1, C2)
+    -> detail::to_bitset_domain_t<detail::intersection_bits<C1, C2>>
+{
+  return {};
+}
+
+template <interval_set C1, interval_set C2>
+  requires (not(discrete<C1> and discrete<C2>))
+[[nodiscard]]
+constexpr auto operator|(C1, C2)
+    -> detail::to_interval_domain_t<detail::union_intervals<C1, C2>>
+{
+  return {};
+}
+
+template <interval_set C1, interval_set C2>
+  requires (not(discrete<C1> and discrete<C2>))
+[[nodiscard]]
+constexpr auto operator&(C1, C2)
+    -> detail::to_interval_domain_t<detail::intersection_intervals<C1, C2>>
+{
+  return {};
+}
+
+/// @}
+
+/// refinement of a discrete constraint or of an interval union
+///
+/// Every value of `c` must be an element of `existing`. A constraint that is
+/// not discrete does not refine a discrete constraint, even if it has the same
+/// bounds.
+///
+/// @{
+
+template <class Constraint, integer_type Offset, std::uint64_t... Words>
+[[nodiscard]]
+constexpr auto refines(
+    const Constraint& c, const bitset_domain<Offset, Words...>& existing)
+    -> bool
+{
+  if constexpr (is_interval_union_v<Constraint>) {
+    const auto b = c.bounds();
+    for (auto i = std::size_t{}; i != b.size(); i += 2) {
+      if (not detail::is_integer(b[i]) or b[i] != b[i + 1] or
+          not existing.contains(static_cast<integer_type>(b[i]))) {
+        return false;
+      }
+    }
+    return true;
+  } else if constexpr (not discrete<Constraint>) {
+    return false;
+  } else if constexpr (not detail::is_small_v<Constraint>) {
+    // spans more words than any small domain
+    return false;
+  } else {
+    return c.min() >= existing.min() and c.max() <= existing.max() and
+           detail::is_subset(
+               detail::bits_of<Constraint>::value(),
+               bitset_domain<Offset, Words...>::data());
+  }
+}
+
+template <class Constraint, std::integral auto Min, std::integral auto Max>
+[[nodiscard]]
+constexpr auto refines(
+    const Constraint& c, const ordered<constant<Min>, constant<Max>>&) -> bool
+{
+  if constexpr (is_interval_union_v<Constraint>) {
+    const auto b = c.bounds();
+    for (auto i = std::size_t{}; i != b.size(); i += 2) {
+      if (not detail::is_integer(b[i]) or b[i] != b[i + 1] or
+          std::cmp_less(static_cast<integer_type>(b[i]), Min) or
+          std::cmp_greater(static_cast<integer_type>(b[i]), Max)) {
+        return false;
+      }
+    }
+    return true;
+  } else if constexpr (not discrete<Constraint>) {
+    return false;
+  } else {
+    return std::cmp_greater_equal(c.min(), Min) and
+           std::cmp_less_equal(c.max(), Max);
+  }
+}
+
+template <class Constraint, real_type... Bounds>
+[[nodiscard]]
+constexpr auto
+refines(const Constraint& c, const interval_union<Bounds...>&) -> bool
+{
+  constexpr auto existing = interval_union<Bounds...>::intervals();
+
+  if constexpr (interval_set<Constraint> and discrete<Constraint>) {
+    // a small domain may have more elements than an interval union
+    constexpr auto bits = detail::bits_of<Constraint>::value();
+    for (auto i = std::size_t{}; i != bits.size; ++i) {
+      for (auto bit = 0; bit != detail::word_bits; ++bit) {
+        if (((bits.words[i] >> bit) & 1U) == 0) {
+          continue;
+        }
+        const auto v =
+            bits.offset + (static_cast<integer_type>(i) * detail::word_bits) +
+            bit;
+        if (not existing.encloses(
+                detail::round_down<real_type>(v),
+                detail::round_up<real_type>(v))) {
+          return false;
+        }
+      }
+    }
+    return true;
+  } else if constexpr (interval_set<Constraint>) {
+    constexpr auto intervals = detail::intervals_of<Constraint>::value();
+    for (auto i = std::size_t{}; i != intervals.size; ++i) {
+      if (not existing.encloses(intervals.min(i), intervals.max(i))) {
+        return false;
+      }
+    }
+    return true;
+  } else {
+    return existing.encloses(
+        detail::round_down<real_type>(c.min()),
+        detail::round_up<real_type>(c.max()));
+  }
+}
+
+/// @}
+
+}  // namespace constraint
+}  // namespace sym
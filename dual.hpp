@@ -0,0 +1,365 @@
+#pragma once
+
+#include "constraint.hpp"
+#include "detail/string_hash.hpp"
+#include "expression.hpp"
+#include "symbol.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sym {
+
+/// enclosures of the value and of the derivative of an expression
+///
+/// Passed to each op's `derivative` rule, which returns the derivative
+/// enclosure of the op from the enclosures of its arguments. Value enclosures
+/// are computed with each op's `enclosure` rule, i.e. with interval
+/// arithmetic rather than the aggregate constraint.
+///
+template <class T>
+struct dual_enclosure
+{
+  constraint::basic_any_ordered<T> value;
+  constraint::basic_any_ordered<T> tangent;
+};
+
+namespace detail {
+
+template <class... Ts>
+constexpr auto
+derivative_enclosure(const symbol<Ts...>& s, std::string_view name)
+    -> dual_enclosure<constraint::real_type>
+{
+  const auto d = s.name() == name ? constraint::real_type{1}
+                                  : constraint::real_type{};
+  return {constraint::any_ordered{s.constraint()}, {d, d}};
+}
+
+template <class Op, class Args, class Constraint>
+constexpr auto derivative_enclosure(
+    const expression<Op, Args, Constraint>& ex, std::string_view name)
+    -> dual_enclosure<constraint::real_type>
+{
+  return std::apply(
+      [name](const auto&... args) {
+        const auto ds = std::tuple{derivative_enclosure(args, name)...};
+        return dual_enclosure<constraint::real_type>{
+            std::apply(
+                [](const auto&... d) {
+                  return typename Op::enclosure{}(d.value...);
+                },
+                ds),
+            std::apply(
+                [](const auto&... d) {
+                  return typename Op::derivative{}(d...);
+                },
+                ds)};
+      },
+      ex.args());
+}
+
+}  // namespace detail
+
+/// enclosure of the partial derivative of an expression with respect to the
+/// symbol `name`, over all values satisfying the symbol constraints
+///
+/// A derivative enclosure of `[0, 0]` proves that the expression does not
+/// depend on the symbol.
+///
+/// example:
+///
+/// ~~~{.cpp}
+/// derivative_enclosure(x + x + y, "x");  // double: [2, 2]
+/// derivative_enclosure(x + x + y, "z");  // double: [0, 0]
+/// ~~~
+///
+inline constexpr struct
+{
+  template <class... Ts>
+  [[nodiscard]]
+  static constexpr auto
+  operator()(const expression<Ts...>& ex, std::string_view name)
+      -> constraint::any_ordered
+  {
+    return detail::derivative_enclosure(ex, name).tangent;
+  }
+} derivative_enclosure{};
+
+/// block of dual numbers
+///
+/// Stores the values of `rows()` evaluations and their derivatives in
+/// `directions()` seed directions as structures of arrays: a value column and
+/// one tangent column per direction. Arithmetic operates on whole columns so
+/// that evaluation of an expression is vectorized across rows.
+///
+/// Derivatives in inactive directions are zero. Their tangent columns are not
+/// allocated and are skipped by arithmetic.
+///
+template <class T = constraint::real_type>
+class [[nodiscard]] dual_block
+{
+  std::size_t rows_{};
+  std::vector<T> values_{};
+  std::vector<std::vector<T>> tangents_{};
+  std::vector<bool> active_{};
+
+public:
+  using value_type = T;
+
+  /// constructs a block of zero values with all directions inactive
+  ///
+  dual_block(std::size_t rows, std::size_t directions)
+      : rows_{rows}, values_(rows), tangents_(directions), active_(directions)
+  {}
+
+  [[nodiscard]]
+  auto rows() const -> std::size_t
+  {
+    return rows_;
+  }
+
+  [[nodiscard]]
+  auto directions() const -> std::size_t
+  {
+    return active_.size();
+  }
+
+  [[nodiscard]]
+  auto value() -> std::span<T>
+  {
+    return values_;
+  }
+  [[nodiscard]]
+  auto value() const -> std::span<const T>
+  {
+    return values_;
+  }
+
+  /// tangent column of direction `k`
+  ///
+  /// Empty if the direction is inactive.
+  ///
+  /// @{
+
+  [[nodiscard]]
+  auto tangent(std::size_t k) -> std::span<T>
+  {
+    assert(k < directions());
+    return tangents_[k];
+  }
+  [[nodiscard]]
+  auto tangent(std::size_t k) const -> std::span<const T>
+  {
+    assert(k < directions());
+    return tangents_[k];
+  }
+
+  /// @}
+
+  /// `true` if the tangent column of direction `k` may be non-zero
+  ///
+  [[nodiscard]]
+  auto active(std::size_t k) const -> bool
+  {
+    assert(k < directions());
+    return active_[k];
+  }
+
+  /// allocates a zero tangent column for direction `k` if it is inactive
+  ///
+  auto activate(std::size_t k) -> void
+  {
+    assert(k < directions());
+    if (not active_[k]) {
+      tangents_[k].resize(rows_);
+      active_[k] = true;
+    }
+  }
+
+  /// dual number addition
+  ///
+  friend auto operator+(dual_block lhs, const dual_block& rhs) -> dual_block
+  {
+    assert(
+        lhs.rows() == rhs.rows() and lhs.directions() == rhs.directions() and
+        "dual blocks must have the same shape");
+
+    const auto add = [](std::span<T> x, std::span<const T> y) {
+      for (auto i = std::size_t{}; i != x.size(); ++i) {
+        x[i] += y[i];
+      }
+    };
+
+    add(lhs.value(), rhs.value());
+    for (auto k = std::size_t{}; k != lhs.directions(); ++k) {
+      if (not rhs.active(k)) {
+        continue;
+      }
+      if (lhs.active(k)) {
+        add(lhs.tangent(k), rhs.tangent(k));
+      } else {
+        lhs.tangents_[k] = rhs.tangents_[k];
+        lhs.active_[k] = true;
+      }
+    }
+    return lhs;
+  }
+};
+
+/// inputs to `evaluate_dual`
+///
+/// Binds a value column to each symbol name and seeds a derivative direction
+/// for each symbol whose partial derivatives are requested. Columns are not
+/// owned and must outlive the inputs.
+///
+/// example:
+///
+/// ~~~{.cpp}
+/// const auto xs = std::vector{1.0, 2.0, 3.0};
+/// const auto ys = std::vector{4.0, 5.0, 6.0};
+///
+/// auto inputs = dual_inputs{3};
+/// inputs.bind("x", xs).bind("y", ys);
+/// const auto dx = inputs.seed("x");
+///
+/// const auto result = evaluate_dual(x + y, inputs);
+/// result.value();        // {5, 7, 9}
+/// result.tangent(dx);    // {1, 1, 1}
+/// ~~~
+///
+template <class T = constraint::real_type>
+class dual_inputs
+{
+  std::size_t rows_;
+  std::unordered_map<
+      std::string,
+      std::span<const T>,
+      detail::string_hash,
+      std::equal_to<>>
+      columns_{};
+  std::vector<std::string> seeds_{};
+
+public:
+  explicit dual_inputs(std::size_t rows) : rows_{rows} {}
+
+  [[nodiscard]]
+  auto rows() const -> std::size_t
+  {
+    return rows_;
+  }
+
+  /// binds the values of symbol `name`
+  ///
+  auto bind(std::string_view name, std::span<const T> column) -> dual_inputs&
+  {
+    assert(column.size() == rows_ and "column size must equal rows");
+    columns_.insert_or_assign(std::string{name}, column);
+    return *this;
+  }
+
+  /// values bound to symbol `name`
+  ///
+  [[nodiscard]]
+  auto column(std::string_view name) const -> std::span<const T>
+  {
+    const auto it = columns_.find(name);
+    assert(it != columns_.end() and "symbol values must be bound");
+    return it->second;
+  }
+
+  /// seeds a derivative direction for symbol `name`
+  ///
+  /// returns the index of the direction
+  ///
+  auto seed(std::string_view name) -> std::size_t
+  {
+    const auto it = std::ranges::find(seeds_, name);
+    if (it != seeds_.end()) {
+      return static_cast<std::size_t>(it - seeds_.begin());
+    }
+    seeds_.emplace_back(name);
+    return seeds_.size() - 1;
+  }
+
+  /// seeded symbol names, indexed by direction
+  ///
+  [[nodiscard]]
+  auto seeds() const -> std::span<const std::string>
+  {
+    return seeds_;
+  }
+};
+
+namespace detail {
+
+template <class T, class... Ts>
+auto evaluate_dual(
+    const symbol<Ts...>& s,
+    const dual_inputs<T>& inputs,
+    const std::vector<bool>& relevant) -> dual_block<T>
+{
+  auto block = dual_block<T>{inputs.rows(), inputs.seeds().size()};
+  std::ranges::copy(inputs.column(s.name()), block.value().begin());
+
+  for (auto k = std::size_t{}; k != block.directions(); ++k) {
+    if (relevant[k] and inputs.seeds()[k] == s.name()) {
+      block.activate(k);
+      std::ranges::fill(block.tangent(k), T{1});
+    }
+  }
+  return block;
+}
+
+template <class T, class Op, class Args, class Constraint>
+auto evaluate_dual(
+    const expression<Op, Args, Constraint>& ex,
+    const dual_inputs<T>& inputs,
+    const std::vector<bool>& relevant) -> dual_block<T>
+{
+  return std::apply(
+      [&](const auto&... args) {
+        return dual_block<T>{ex.op()(evaluate_dual(args, inputs, relevant)...)};
+      },
+      ex.args());
+}
+
+}  // namespace detail
+
+/// forward-mode evaluation of an expression and its partial derivatives
+///
+/// Evaluates the value and every seeded derivative direction of all rows in a
+/// single pass over the expression, applying each op's function object to
+/// `dual_block`s. Directions of symbols with a derivative enclosure of
+/// `[0, 0]` are proven irrelevant and left inactive.
+///
+inline constexpr struct
+{
+  template <class T, class... Ts>
+  [[nodiscard]]
+  static auto
+  operator()(const expression<Ts...>& ex, const dual_inputs<T>& inputs)
+      -> dual_block<T>
+  {
+    const auto zero = constraint::any_ordered{0.0, 0.0};
+
+    auto relevant = std::vector<bool>{};
+    relevant.reserve(inputs.seeds().size());
+    for (const auto& name : inputs.seeds()) {
+      relevant.push_back(not(derivative_enclosure(ex, name) == zero));
+    }
+
+    return detail::evaluate_dual(ex, inputs, relevant);
+  }
+} evaluate_dual{};
+
+}  // namespace sym
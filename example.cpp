@@ -1,6 +1,12 @@
+#include "shared_constraint_store.hpp"
 #include "sym.hpp"
 
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
 
 using namespace sym;
 
@@ -70,6 +76,157 @@ auto main() -> int
     static_assert(sizeof(x_plus_y) == 1);
   }
 
+  // construct a symbol with a constraint of a different value type
+  {
+    constexpr auto x = "x"_symbol[constraint::basic_positive<float>];
+    std::cout << x << "\n";
+    // symbol(x) [float: [1.4013e-45, inf]]
+
+    static_assert(sizeof(x) == 1);
+  }
+
+  // construct an expression from two symbols with discrete constraints
+  {
+    constexpr auto x = "x"_symbol[constraint::integer_range<0, 0> |
+                                  constraint::integer_range<2, 2> |
+                                  constraint::integer_range<5, 9>];
+    constexpr auto y = "y"_symbol[constraint::one_of<1, 3>];
+    constexpr auto x_plus_y = x + y;
+
+    std::cout << x_plus_y << "\n";
+    // expression { sym::op::plus, expression { sym::op::identity, symbol(x) [long: {0, 2, 5..9}] } long: {0, 2, 5..9}, expression { sym::op::identity, symbol(y) [long: {1, 3}] } long: {1, 3} } long: {0..3, 5..9}
+
+    static_assert(sizeof(x_plus_y) == 1);
+  }
+
+  // construct an expression from two symbols with discrete and real
+  // constraints
+  {
+    constexpr auto x = "x"_symbol[constraint::one_of<-1, 2>];
+    constexpr auto y =
+        "y"_symbol[constraint::ordered{constant<0.5>{}, constant<0.7>{}}];
+    constexpr auto x_plus_y = x + y;
+
+    std::cout << x_plus_y.constraint() << "\n";
+    // double: {-1, [0.5, 0.7], 2}
+
+    static_assert(sizeof(x_plus_y) == 1);
+  }
+
+  // index expressions by the symbols they use
+  {
+    const auto x = symbol{"x"};
+    const auto y = symbol{"y"};
+    const auto z = symbol{"z"};
+
+    auto index = symbol_index{};
+    const auto e1 = index.insert(x + y);
+    index.insert(y + z);
+
+    std::cout << index.expressions_using("y").size() << "\n";
+    // 2
+
+    index.erase(e1);
+    std::cout << index.expressions_using_all({"x", "y"}).size() << "\n";
+    // 0
+  }
+
+  // share runtime constraints between processes
+  {
+    const auto path = std::filesystem::temp_directory_path() / "sym_example";
+    const auto x = symbol{"x"}[constraint::positive];
+    const auto y = symbol{"y"}[constraint::negative];
+
+    auto writer = shared_constraint_store::create(path, 64);
+    writer.store(x);
+    writer.store(x + y);
+
+    auto reader = shared_constraint_store::open(path);
+    std::cout << *reader.load("x") << "\n";
+    // double: [4.94066e-324, inf]
+
+    std::cout << *reader.load(x + y) << "\n";
+    // double: [-inf, inf]
+
+    writer = shared_constraint_store::create(path, 64);
+    std::cout << reader.replaced() << "\n";
+    // 1
+
+    std::filesystem::remove(path);
+  }
+
+  // validate many expressions at once
+  {
+    const auto x = symbol{"x"}[constraint::positive];
+    const auto y = symbol{"y"}[constraint::negative];
+    const auto z = symbol{"x"}[constraint::negative];
+
+    auto expressions = std::vector<decltype(x + y)>{};
+    for (auto i = 0; i != 100; ++i) {
+      expressions.push_back(plus(unchecked, x, i == 42 ? z : y));
+    }
+
+    auto views = std::vector<any_expression_view>{};
+    for (const auto& ex : expressions) {
+      views.emplace_back(ex);
+    }
+
+    std::cout << validate_batch(views, {.chunk_size = 10}).failures().front()
+              << "\n";
+    // 42
+  }
+
+  // cache propagated constraints
+  {
+    const auto x = symbol{"x"}[constraint::positive];
+    const auto y = symbol{"y"}[constraint::negative];
+
+    auto cache = propagation_cache{1024};
+    std::cout << cache.propagate(x + y) << "\n";
+    // double: [-inf, inf]
+
+    std::cout << cache.propagate(x + y) << "\n";
+    // double: [-inf, inf]
+
+    std::cout << cache.hits() << "\n";
+    // 1
+  }
+
+  // evaluate an expression and its derivatives over columns of values
+  {
+    const auto x = symbol{"x"};
+    const auto y = symbol{"y"};
+
+    const auto xs = std::vector{1.0, 2.0, 3.0};
+    const auto ys = std::vector{4.0, 5.0, 6.0};
+
+    auto inputs = dual_inputs{3};
+    inputs.bind("x", xs).bind("y", ys);
+    const auto dx = inputs.seed("x");
+
+    const auto result = evaluate_dual(x + x + y, inputs);
+    std::cout << result.value()[2] << " " << result.tangent(dx)[2] << "\n";
+    // 12 2
+  }
+
+  // allocate symbols and expressions from an arena
+  {
+    auto arena = arena_resource{};
+    const auto alloc = std::pmr::polymorphic_allocator<>{&arena};
+
+    auto x = symbol{std::pmr::string{"x", alloc}}[constraint::positive];
+    auto y = symbol{std::pmr::string{"y", alloc}}[constraint::negative];
+
+    auto exprs = std::pmr::vector<decltype(x + y)>{alloc};
+    exprs.push_back(plus(std::allocator_arg, alloc, x, y));
+
+    std::cout << exprs.front().constraint() << "\n";
+    // double: [-inf, inf]
+
+    exprs.clear();
+    arena.release();
+  }
+
 #if 0
   // constraint application on a symbol must be a refinement
   {
@@ -1,22 +1,118 @@
 #pragma once
 
+#include "detail/descriptor.hpp"
+#include "detail/name_hash.hpp"
+#include "detail/print.hpp"
 #include "detail/static_instance.hpp"
 #include "detail/tuple_for_each.hpp"
+#include "detail/type_name.hpp"
 #include "op/identity.hpp"
 #include "symbol.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <ostream>
+#include <span>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace sym {
+namespace detail {
+
+/// `true` if all symbols with the same name have the same constraint
+///
+/// Shared by all `check_symbol_constraints` instantiations. Reorders
+/// `symbols`.
+///
+constexpr auto
+has_consistent_constraints(std::span<any_symbol_view> symbols) -> bool
+{
+  std::ranges::sort(symbols, std::ranges::less{}, &any_symbol_view::name);
+
+  const auto it =
+      std::ranges::adjacent_find(symbols, [](const auto& s1, const auto& s2) {
+        return s1.name() == s2.name() and
+               (s1.constraint() != s2.constraint() or
+                s1.domain() != s2.domain());
+      });
+
+  return it == symbols.end();
+}
+
+/// expression visitor counting symbols
+///
+struct count_symbols
+{
+  std::size_t count{};
+
+  template <class... Ts>
+  constexpr auto operator()(const symbol<Ts...>&)
+  {
+    ++count;
+  }
+};
+
+/// expression precondition visitor for expressions of `_symbol` literals
+///
+/// Checks the same precondition as `check_symbol_constraints` with an
+/// open-addressing table of symbols keyed by the compile-time hash of their
+/// names, avoiding the sort during constant evaluation. `Capacity` must be
+/// greater than the number of symbols.
+///
+template <std::size_t Capacity>
+class static_symbol_table
+{
+  std::array<std::uint64_t, Capacity> hashes_{};
+  std::array<std::optional<any_symbol_view>, Capacity> symbols_{};
+  bool consistent_{true};
+
+public:
+  template <class String, class Constraint>
+  constexpr auto operator()(const symbol<String, Constraint>& s)
+  {
+    const auto hash = [&s] {
+      if constexpr (requires { String::hash; }) {
+        return String::hash;
+      } else {
+        return name_hash(s.name());
+      }
+    }();
+
+    for (auto i = hash % Capacity;; i = (i + 1) % Capacity) {
+      auto& slot = symbols_[i];
+      if (not slot) {
+        hashes_[i] = hash;
+        slot.emplace(s);
+        return;
+      }
+      if (hashes_[i] == hash and slot->name() == s.name()) {
+        const auto view = any_symbol_view{s};
+        consistent_ = consistent_ and
+                      slot->constraint() == view.constraint() and
+                      slot->domain() == view.domain();
+        return;
+      }
+    }
+  }
+
+  [[nodiscard]]
+  constexpr operator bool() const
+  {
+    return consistent_;
+  }
+};
+
+}  // namespace detail
 
 /// expression precondition visitors
 ///
@@ -50,23 +146,34 @@ struct check_symbol_constraints
   {
     symbols.emplace_back(s);
   }
+  constexpr auto operator()(const any_symbol_view& s)
+  {
+    symbols.push_back(s);
+  }
 
   [[nodiscard]]
   constexpr operator bool()
   {
-    std::ranges::sort(symbols, std::ranges::less{}, &any_symbol_view::name);
-
-    const auto it =
-        std::ranges::adjacent_find(symbols, [](const auto& s1, const auto& s2) {
-          return s1.name() == s2.name() and s1.constraint() != s2.constraint();
-        });
-
-    return it == symbols.cend();
+    return detail::has_consistent_constraints(symbols);
   }
 };
 
 /// @}
 
+/// tag selecting construction of an expression without validating its
+/// symbolic constraints
+///
+/// For expressions that are validated later, e.g. all at once with
+/// `validate_batch`. Expressions with only compile-time symbols are still
+/// validated at compile time unless constructed with this tag.
+///
+struct unchecked_t
+{
+  explicit unchecked_t() = default;
+};
+
+inline constexpr auto unchecked = unchecked_t{};
+
 namespace detail {
 
 template <class Args>
@@ -78,10 +185,15 @@ struct args_base
   Args args_;
 
   [[nodiscard]]
-  constexpr auto args() const -> const Args&
+  constexpr auto args() const& -> const Args&
   {
     return args_;
   }
+  [[nodiscard]]
+  constexpr auto args() && -> Args&&
+  {
+    return std::move(args_);
+  }
 };
 
 template <class... Ts>
@@ -95,12 +207,26 @@ struct args_base<std::tuple<Ts...>>
   constexpr explicit args_base(std::tuple<Ts...>) {}
 
   [[nodiscard]]
-  constexpr auto args() const -> const std::tuple<Ts...>&
+  constexpr auto args() const& -> const std::tuple<Ts...>&
   {
     return static_instance<std::tuple<Ts...>>;
   }
+  [[nodiscard]]
+  constexpr auto args() && -> std::tuple<Ts...>
+  {
+    return {};
+  }
 };
 
+/// scratch space used to validate an expression constructed with an
+/// allocator
+///
+template <class Alloc>
+using scratch_vector = std::vector<
+    any_symbol_view,
+    typename std::allocator_traits<Alloc>::template rebind_alloc<
+        any_symbol_view>>;
+
 template <template <class...> class list, class... Ts>
 static consteval auto determined_unconstrained(std::type_identity<list<Ts...>>)
     -> std::bool_constant<(Ts::is_unconstrained and ...)>
@@ -123,6 +249,62 @@ constexpr auto visitor_adaptor(std::reference_wrapper<Visitor> v)
   };
 }
 
+/// non-owning type-erased reference to a visitor of symbol views
+///
+class symbol_visitor_ref
+{
+  void* visitor_;
+  auto (*visit_)(void*, const any_symbol_view&) -> void;
+
+public:
+  template <class Visitor>
+  explicit symbol_visitor_ref(Visitor& v)
+      : visitor_{&v}, visit_{[](void* ptr, const any_symbol_view& s) {
+          std::invoke(*static_cast<Visitor*>(ptr), s);
+        }}
+  {}
+
+  auto operator()(const any_symbol_view& s) const -> void
+  {
+    visit_(visitor_, s);
+  }
+};
+
+/// visiting cores shared by all expression types
+///
+/// Used instead of per-type visitation when `SYM_COMPACT_CODEGEN` is defined.
+/// Calls `v` with a view of every symbol described by `node`, in visitation
+/// order. `names` are the names of these symbols.
+///
+/// @{
+
+inline auto visit_node(
+    const node_descriptor& node,
+    const std::string_view*& name,
+    symbol_visitor_ref v) -> void
+{
+  if (node.is_symbol) {
+    v(any_symbol_view{*name++, *node.constraint});
+    return;
+  }
+  for (const auto* child : node.children) {
+    visit_node(*child, name, v);
+  }
+}
+
+inline auto visit_symbols(
+    const node_descriptor& node,
+    std::span<const std::string_view> names,
+    symbol_visitor_ref v) -> void
+{
+  assert(names.size() == node.symbols and "one name is required per symbol");
+
+  const auto* name = names.data();
+  visit_node(node, name, v);
+}
+
+/// @}
+
 }  // namespace detail
 
 /// expression type
@@ -144,11 +326,23 @@ private:
   constexpr expression(PreconditionVisitor precondition, Args args)
       : args_base_type{std::move(args)}
   {
-    if constexpr (is_unconstrained) {
+    if constexpr (
+        is_unconstrained or
+        std::is_same_v<PreconditionVisitor, skip_precondition_check>) {
       // do nothing
     } else if constexpr (args_base_type::is_empty) {
+      static constexpr auto size = [] {
+        auto v = detail::count_symbols{};
+        const auto args = args_base_type{}.args();
+
+        detail::tuple_for_each(args, detail::visitor_adaptor(std::ref(v)));
+
+        return v.count;
+      }();
+
       static constexpr auto check = [] {
-        auto v = check_symbol_constraints<std::vector<any_symbol_view>>{};
+        // load factor of at most 1/2
+        auto v = detail::static_symbol_table<(2 * size) + 1>{};
         const auto args = args_base_type{}.args();
 
         detail::tuple_for_each(args, detail::visitor_adaptor(std::ref(v)));
@@ -181,6 +375,53 @@ public:
             std::move(args)}
   {}
 
+  /// constructs an expression without validating its symbolic constraints
+  ///
+  constexpr expression(unchecked_t, Args args)
+      : expression{skip_precondition_check{}, std::move(args)}
+  {}
+
+  /// allocator-extended constructors
+  ///
+  /// Symbol names are allocated with `alloc`. Constructing from `args`
+  /// also allocates the validation scratch space with `alloc`. Copying or
+  /// moving from another expression does not validate it again.
+  ///
+  /// These constructors make `expression` a uses-allocator type, so
+  /// containers such as `std::pmr::vector` store expression trees entirely in
+  /// their memory resource.
+  ///
+  /// @{
+
+  template <class Alloc>
+  constexpr expression(std::allocator_arg_t, const Alloc& alloc, Args args)
+      : expression{
+            [&alloc] {
+              if constexpr (is_unconstrained) {
+                return skip_precondition_check{};
+              } else {
+                return check_symbol_constraints<detail::scratch_vector<Alloc>>{
+                    detail::scratch_vector<Alloc>(alloc)};
+              }
+            }(),
+            Args(std::allocator_arg, alloc, std::move(args))}
+  {}
+
+  template <class Alloc>
+  constexpr expression(
+      std::allocator_arg_t, const Alloc& alloc, const expression& other)
+      : args_base_type{Args(std::allocator_arg, alloc, other.args())}
+  {}
+
+  template <class Alloc>
+  constexpr expression(
+      std::allocator_arg_t, const Alloc& alloc, expression&& other)
+      : args_base_type{
+            Args(std::allocator_arg, alloc, std::move(other).args())}
+  {}
+
+  /// @}
+
   [[nodiscard]]
   constexpr auto op() const -> const op_type&
   {
@@ -193,15 +434,34 @@ public:
     return detail::static_instance<constraint_type>;
   }
 
+  /// calls a visitor with every symbol in the expression
+  ///
+  /// If `SYM_COMPACT_CODEGEN` is defined, a visitor invocable with
+  /// `any_symbol_view` is called with symbol views during runtime evaluation.
+  ///
   template <class Visitor>
   constexpr auto visit(Visitor v) const
   {
+#ifdef SYM_COMPACT_CODEGEN
+    if constexpr (std::is_invocable_v<Visitor&, const any_symbol_view&>) {
+      if !consteval {
+        return detail::visit_symbols(
+            detail::node_descriptor_v<expression>,
+            detail::symbol_names(*this),
+            detail::symbol_visitor_ref{v});
+      }
+    }
+#endif
     detail::tuple_for_each(args(), detail::visitor_adaptor(v));
   }
 
   friend auto operator<<(std::ostream& os, const expression& ex) -> auto&
   {
-    os << "expression { " << detail::type_name<op_type>();
+#ifdef SYM_COMPACT_CODEGEN
+    return detail::print(
+        os, detail::node_descriptor_v<expression>, detail::symbol_names(ex));
+#else
+    os << "expression { " << detail::op_name<op_type>();
 
     [&]<std::size_t... Is>(std::index_sequence<Is...>) {
       auto _ = ((os << ", " << std::get<Is>(ex.args()), 0) + ...);
@@ -210,6 +470,7 @@ public:
     os << " } ";
     os << ex.constraint();
     return os;
+#endif
   }
 };
 
@@ -218,6 +479,9 @@ public:
 /// if value is an expression, return that expression
 /// if value is a symbol, promote to an expression using the identity operation
 ///
+/// If invoked with `std::allocator_arg` and an allocator, the resulting
+/// expression is constructed with that allocator.
+///
 /// @{
 
 inline constexpr struct
@@ -239,6 +503,53 @@ inline constexpr struct
   {
     return R{std::tuple{std::move(s)}};
   }
+
+  template <class Alloc, class... Ts>
+  [[nodiscard]]
+  static constexpr auto operator()(
+      std::allocator_arg_t, const Alloc& alloc, const expression<Ts...>& ex)
+      -> expression<Ts...>
+  {
+    return std::make_obj_using_allocator<expression<Ts...>>(alloc, ex);
+  }
+  template <class Alloc, class... Ts>
+  [[nodiscard]]
+  static constexpr auto operator()(
+      std::allocator_arg_t, const Alloc& alloc, expression<Ts...>&& ex)
+      -> expression<Ts...>
+  {
+    return std::make_obj_using_allocator<expression<Ts...>>(
+        alloc, std::move(ex));
+  }
+  template <
+      class Alloc,
+      class... Ts,
+      class R = expression<
+          op::identity,
+          std::tuple<symbol<Ts...>>,
+          typename symbol<Ts...>::constraint_type>>
+  [[nodiscard]]
+  static constexpr auto operator()(
+      std::allocator_arg_t, const Alloc& alloc, const symbol<Ts...>& s) -> R
+  {
+    return R{
+        std::allocator_arg,
+        alloc,
+        std::tuple{std::make_obj_using_allocator<symbol<Ts...>>(alloc, s)}};
+  }
+  template <
+      class Alloc,
+      class... Ts,
+      class R = expression<
+          op::identity,
+          std::tuple<symbol<Ts...>>,
+          typename symbol<Ts...>::constraint_type>>
+  [[nodiscard]]
+  static constexpr auto operator()(
+      std::allocator_arg_t, const Alloc& alloc, symbol<Ts...>&& s) -> R
+  {
+    return R{std::allocator_arg, alloc, std::tuple{std::move(s)}};
+  }
 } expr{};
 
 /// @}
@@ -248,4 +559,192 @@ inline constexpr struct
 template <class T>
 using sym_expr_t = std::invoke_result_t<decltype(expr), T>;
 
+/// runtime constraint propagation
+///
+/// Computes the constraint of an expression from the constraints of its
+/// symbols by applying each op's constraint rule to type-erased constraints.
+/// For expressions built from compile-time known constraints, the result
+/// equals `constraint::any_ordered{ex.constraint()}`.
+///
+/// @{
+
+namespace detail {
+
+template <class... Ts>
+constexpr auto propagate(const symbol<Ts...>& s) -> constraint::any_ordered
+{
+  return constraint::any_ordered{s.constraint()};
+}
+
+template <class Op, class Args, class Constraint>
+constexpr auto propagate(const expression<Op, Args, Constraint>& ex)
+    -> constraint::any_ordered
+{
+  return std::apply(
+      [](const auto&... args) {
+        return typename Op::constraint{}(propagate(args)...);
+      },
+      ex.args());
+}
+
+}  // namespace detail
+
+inline constexpr struct
+{
+  template <class... Ts>
+  [[nodiscard]]
+  static constexpr auto
+  operator()(const expression<Ts...>& ex) -> constraint::any_ordered
+  {
+    return detail::propagate(ex);
+  }
+} propagate{};
+
+/// @}
+
+/// key identifying the runtime propagation of an expression
+///
+/// `structure` hashes the ops and symbol names of an expression tree and
+/// `bounds` hashes the constraint bounds of its symbols. Different
+/// expressions may have equal keys, although with negligible probability.
+///
+struct propagation_key
+{
+  std::uint64_t structure{};
+  std::uint64_t bounds{};
+
+  [[nodiscard]]
+  friend constexpr auto
+  operator==(const propagation_key&, const propagation_key&) -> bool = default;
+};
+
+namespace detail {
+
+constexpr auto
+hash_combine(std::uint64_t seed, std::uint64_t value) -> std::uint64_t
+{
+  return seed ^ (value + 0x9e3779b97f4a7c15U + (seed << 6U) + (seed >> 2U));
+}
+
+template <class... Ts>
+constexpr auto structural_key(const symbol<Ts...>& s) -> propagation_key
+{
+  const auto c = constraint::any_ordered{s.constraint()};
+  return {
+      name_hash(s.name()),
+      hash_combine(
+          std::bit_cast<std::uint64_t>(c.min()),
+          std::bit_cast<std::uint64_t>(c.max()))};
+}
+
+template <class... Ts, class F>
+constexpr auto structural_key(const symbol<Ts...>& s, F&) -> propagation_key
+{
+  return structural_key(s);
+}
+
+/// computes the key of an expression bottom-up from the keys of its
+/// arguments, passing the key of every subexpression to `on_key` in
+/// post-order
+///
+template <class Op, class Args, class Constraint, class F>
+constexpr auto
+structural_key(const expression<Op, Args, Constraint>& ex, F& on_key)
+    -> propagation_key
+{
+  auto key = propagation_key{name_hash(op_name<Op>()), {}};
+
+  std::apply(
+      [&key, &on_key](const auto&... args) {
+        const auto combine = [&key](const propagation_key& arg) {
+          key.structure = hash_combine(key.structure, arg.structure);
+          key.bounds = hash_combine(key.bounds, arg.bounds);
+        };
+        (combine(structural_key(args, on_key)), ...);
+      },
+      ex.args());
+
+  on_key(ex, key);
+  return key;
+}
+
+template <class Op, class Args, class Constraint>
+constexpr auto structural_key(const expression<Op, Args, Constraint>& ex)
+    -> propagation_key
+{
+  auto ignore = [](const auto&, const propagation_key&) {};
+  return structural_key(ex, ignore);
+}
+
+}  // namespace detail
+
+/// obtain the `propagation_key` of an expression
+///
+inline constexpr struct
+{
+  template <class... Ts>
+  [[nodiscard]]
+  static constexpr auto
+  operator()(const expression<Ts...>& ex) -> propagation_key
+  {
+    return detail::structural_key(ex);
+  }
+} structural_key{};
+
+/// non-owning type-erased view of an expression
+///
+/// The viewed expression must outlive the view.
+///
+class [[nodiscard]] any_expression_view
+{
+  const void* ex_;
+  auto (*symbols_)(const void*, std::vector<any_symbol_view>&) -> void;
+  auto (*propagate_)(const void*) -> constraint::any_ordered;
+  auto (*key_)(const void*) -> propagation_key;
+
+public:
+  template <class Expression>
+  constexpr explicit any_expression_view(const Expression& ex)
+      : ex_{&ex},
+        symbols_{[](const void* ptr, std::vector<any_symbol_view>& out) {
+          auto append = [&out](const auto& s) { out.emplace_back(s); };
+          static_cast<const Expression*>(ptr)->visit(std::ref(append));
+        }},
+        propagate_{[](const void* ptr) {
+          return sym::propagate(*static_cast<const Expression*>(ptr));
+        }},
+        key_{[](const void* ptr) {
+          return sym::structural_key(*static_cast<const Expression*>(ptr));
+        }}
+  {}
+
+  /// appends a view of every symbol in the expression to `out`
+  ///
+  auto symbols(std::vector<any_symbol_view>& out) const -> void
+  {
+    symbols_(ex_, out);
+  }
+
+  /// runtime constraint propagation of the viewed expression
+  ///
+  [[nodiscard]]
+  auto propagate() const -> constraint::any_ordered
+  {
+    return propagate_(ex_);
+  }
+
+  /// `propagation_key` of the viewed expression
+  ///
+  [[nodiscard]]
+  auto key() const -> propagation_key
+  {
+    return key_(ex_);
+  }
+};
+
 }  // namespace sym
+
+template <class Op, class Args, class Constraint, class Alloc>
+struct std::uses_allocator<sym::expression<Op, Args, Constraint>, Alloc>
+    : std::true_type
+{};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "constraint.hpp"
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+namespace sym {
+
+/// signed binary fixed-point value
+///
+/// `fixed_point` may be used as the value type of a constraint, e.g. to store
+/// runtime bounds as packed integers. Conversions from floating-point are
+/// saturating and provided as `floor` and `ceil` so that converted constraint
+/// bounds can be rounded outward.
+///
+/// The representation is limited to the precision of `double` so that
+/// conversion to `double` is exact.
+///
+template <std::signed_integral Rep, int FractionalBits>
+  requires (
+      FractionalBits >= 0 and
+      FractionalBits < std::numeric_limits<Rep>::digits and
+      std::numeric_limits<Rep>::digits <= std::numeric_limits<double>::digits)
+struct [[nodiscard]]
+fixed_point
+{
+  using rep = Rep;
+  static constexpr auto fractional_bits = FractionalBits;
+  static constexpr auto scale =
+      static_cast<double>(std::uint64_t{1} << FractionalBits);
+
+  /// raw representation
+  ///
+  /// public so that `fixed_point` is a structural type and may be used with
+  /// `constant`
+  ///
+  Rep raw{};
+
+  [[nodiscard]]
+  static constexpr auto from_raw(Rep r) -> fixed_point
+  {
+    return fixed_point{r};
+  }
+
+  /// greatest representable value not greater than `x`
+  ///
+  [[nodiscard]]
+  static constexpr auto floor(double x) -> fixed_point
+  {
+    const auto scaled = x * scale;
+
+    if (not(scaled > static_cast<double>(std::numeric_limits<Rep>::min()))) {
+      return from_raw(std::numeric_limits<Rep>::min());
+    }
+    if (scaled >= static_cast<double>(std::numeric_limits<Rep>::max())) {
+      return from_raw(std::numeric_limits<Rep>::max());
+    }
+
+    const auto r = static_cast<Rep>(scaled);
+    return from_raw(
+        static_cast<double>(r) > scaled ? static_cast<Rep>(r - 1) : r);
+  }
+
+  /// least representable value not less than `x`
+  ///
+  [[nodiscard]]
+  static constexpr auto ceil(double x) -> fixed_point
+  {
+    return -floor(-x);
+  }
+
+  [[nodiscard]]
+  constexpr explicit operator double() const
+  {
+    return static_cast<double>(raw) / scale;
+  }
+
+  [[nodiscard]]
+  friend constexpr auto operator-(fixed_point x) -> fixed_point
+  {
+    return from_raw(x.raw == std::numeric_limits<Rep>::min()
+                        ? std::numeric_limits<Rep>::max()
+                        : static_cast<Rep>(-x.raw));
+  }
+
+  [[nodiscard]]
+  friend constexpr auto
+  operator<=>(const fixed_point&, const fixed_point&) = default;
+
+  friend auto operator<<(std::ostream& os, fixed_point x) -> std::ostream&
+  {
+    return os << static_cast<double>(x);
+  }
+};
+
+namespace constraint {
+
+/// `fixed_point` has no infinities. The extreme representable values are used
+/// instead.
+///
+template <class Rep, int FractionalBits>
+struct real_traits<fixed_point<Rep, FractionalBits>>
+{
+  using value_type = fixed_point<Rep, FractionalBits>;
+
+  [[nodiscard]]
+  static constexpr auto lowest() -> value_type
+  {
+    return value_type::from_raw(std::numeric_limits<Rep>::min());
+  }
+  [[nodiscard]]
+  static constexpr auto highest() -> value_type
+  {
+    return value_type::from_raw(std::numeric_limits<Rep>::max());
+  }
+  [[nodiscard]]
+  static constexpr auto smallest_positive() -> value_type
+  {
+    return value_type::from_raw(Rep{1});
+  }
+};
+
+}  // namespace constraint
+}  // namespace sym
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 namespace sym::op {
@@ -10,9 +11,13 @@ namespace sym::op {
 /// defines:
 /// 1. indentity of one value (via inheritance of `std::indentity`)
 /// 2. propagated constraint from identity (i.e. the same constrait)
+/// 3. enclosure of the value of identity (i.e. the same enclosure)
+/// 4. enclosure of the derivative of identity (i.e. the same enclosure)
 ///
 struct identity : std::identity
 {
+  static constexpr auto name = std::string_view{"sym::op::identity"};
+
   struct constraint
   {
     template <class T>
@@ -22,6 +27,26 @@ struct identity : std::identity
       return std::forward<T>(t);
     }
   };
+
+  struct enclosure
+  {
+    template <class T>
+    [[nodiscard]]
+    static constexpr auto operator()(const T& t) -> T
+    {
+      return t;
+    }
+  };
+
+  struct derivative
+  {
+    template <class D>
+    [[nodiscard]]
+    static constexpr auto operator()(const D& d) -> decltype(d.tangent)
+    {
+      return d.tangent;
+    }
+  };
 };
 
 }  // namespace sym::op
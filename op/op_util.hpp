@@ -2,6 +2,7 @@
 
 #include "expression.hpp"
 
+#include <memory>
 #include <tuple>
 #include <type_traits>
 
@@ -22,6 +23,11 @@ using op_invoke_result_t = expression<
 /// handles promotion from `symbol` to `expression` and determins the resulting
 /// aggregate constraint type from the operation.
 ///
+/// If invoked with `std::allocator_arg` and an allocator, the resulting
+/// expression and its subexpressions are constructed with that allocator. If
+/// invoked with `unchecked`, the symbolic constraints of the resulting
+/// expression are not validated.
+///
 inline constexpr struct
 {
   template <class Op, class... Args>
@@ -31,6 +37,26 @@ inline constexpr struct
     return op_invoke_result_t<Op, Args&&...>{
         std::tuple{expr(std::forward<Args>(args))...}};
   }
+
+  template <class Op, class... Args>
+  static constexpr auto operator()(unchecked_t, Op, Args&&... args)
+      -> op_invoke_result_t<Op, Args&&...>
+  {
+    return op_invoke_result_t<Op, Args&&...>{
+        unchecked, std::tuple{expr(std::forward<Args>(args))...}};
+  }
+
+  template <class Alloc, class Op, class... Args>
+  static constexpr auto
+  operator()(std::allocator_arg_t, const Alloc& alloc, Op, Args&&... args)
+      -> op_invoke_result_t<Op, Args&&...>
+  {
+    return op_invoke_result_t<Op, Args&&...>{
+        std::allocator_arg,
+        alloc,
+        std::tuple{
+            expr(std::allocator_arg, alloc, std::forward<Args>(args))...}};
+  }
 } op_invoke{};
 
 }  // namespace sym::op
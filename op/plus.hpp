@@ -1,9 +1,12 @@
 #pragma once
 #include "constraint.hpp"
+#include "discrete.hpp"
 #include "op/op_util.hpp"
 
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <string_view>
 #include <utility>
 
 namespace sym {
@@ -13,23 +16,109 @@ namespace op {
 ///
 /// defines:
 /// 1. addition of two values (via inheritance of `std::plus<>`)
-/// 2. aggregate constraint from addition
+/// 2. aggregate constraint from addition, for compile-time constraints and for
+///    type-erased constraints. Bounds of different value types are rounded
+///    outward to their `common_value_type_t`. The aggregate of small domains
+///    is their union, and the aggregate of a small domain or an interval
+///    union with another constraint is their union as an interval union.
+/// 3. enclosure of the value of an addition, from the value enclosures of
+///    each argument, with bounds rounded outward
+/// 4. enclosure of the derivative of an addition, from the value and
+///    derivative enclosures of each argument
 ///
 struct plus : std::plus<>
 {
+  static constexpr auto name = std::string_view{"sym::op::plus"};
+
   struct constraint
   {
     template <class Min1, class Max1, class Min2, class Max2>
     [[nodiscard]]
     static constexpr auto operator()(
-        ::sym::constraint::ordered<Min1, Max1>,
-        ::sym::constraint::ordered<Min2, Max2>)
-        -> ::sym::constraint::ordered<
-            constant<std::min(Min1::value(), Min2::value())>,
-            constant<std::max(Max1::value(), Max2::value())>>
+        ::sym::constraint::ordered<Min1, Max1> c1,
+        ::sym::constraint::ordered<Min2, Max2> c2)
+    {
+      using T = ::sym::constraint::common_value_type_t<
+          typename decltype(c1)::value_type,
+          typename decltype(c2)::value_type>;
+
+      return ::sym::constraint::ordered<
+          constant<std::min(
+              detail::round_down<T>(Min1::value()),
+              detail::round_down<T>(Min2::value()))>,
+          constant<std::max(
+              detail::round_up<T>(Max1::value()),
+              detail::round_up<T>(Max2::value()))>>{};
+    }
+
+    template <
+        ::sym::constraint::discrete C1,
+        ::sym::constraint::discrete C2>
+      requires (::sym::constraint::is_bitset_domain_v<C1> or
+                ::sym::constraint::is_bitset_domain_v<C2>)
+    [[nodiscard]]
+    static constexpr auto operator()(C1 c1, C2 c2) -> decltype(c1 | c2)
     {
       return {};
     }
+
+    template <
+        ::sym::constraint::interval_set C1,
+        ::sym::constraint::interval_set C2>
+      requires (not(::sym::constraint::discrete<C1> and
+                    ::sym::constraint::discrete<C2>) and
+                (::sym::constraint::is_bitset_domain_v<C1> or
+                 ::sym::constraint::is_interval_union_v<C1> or
+                 ::sym::constraint::is_bitset_domain_v<C2> or
+                 ::sym::constraint::is_interval_union_v<C2>))
+    [[nodiscard]]
+    static constexpr auto operator()(C1 c1, C2 c2) -> decltype(c1 | c2)
+    {
+      return {};
+    }
+
+    template <class T1, class T2>
+    [[nodiscard]]
+    static constexpr auto operator()(
+        const ::sym::constraint::basic_any_ordered<T1>& c1,
+        const ::sym::constraint::basic_any_ordered<T2>& c2)
+        -> ::sym::constraint::basic_any_ordered<
+            ::sym::constraint::common_value_type_t<T1, T2>>
+    {
+      using T = ::sym::constraint::common_value_type_t<T1, T2>;
+
+      return {
+          std::min(
+              detail::round_down<T>(c1.min()), detail::round_down<T>(c2.min())),
+          std::max(
+              detail::round_up<T>(c1.max()), detail::round_up<T>(c2.max()))};
+    }
+  };
+
+  struct enclosure
+  {
+    template <class T>
+    [[nodiscard]]
+    static constexpr auto operator()(
+        const ::sym::constraint::basic_any_ordered<T>& c1,
+        const ::sym::constraint::basic_any_ordered<T>& c2)
+        -> ::sym::constraint::basic_any_ordered<T>
+    {
+      return {
+          detail::add_down(c1.min(), c2.min()),
+          detail::add_up(c1.max(), c2.max())};
+    }
+  };
+
+  struct derivative
+  {
+    template <class D1, class D2>
+    [[nodiscard]]
+    static constexpr auto
+    operator()(const D1& d1, const D2& d2) -> decltype(d1.tangent)
+    {
+      return enclosure{}(d1.tangent, d2.tangent);
+    }
   };
 };
 
@@ -42,6 +131,12 @@ struct plus : std::plus<>
 /// ~~~{.cpp}
 /// plus("a"_symbol,  "b"_symbol);
 /// plus(expr, "b"_symbol);
+///
+/// // construct with an allocator
+/// plus(std::allocator_arg, alloc, expr, "b"_symbol);
+///
+/// // construct without validating symbolic constraints
+/// plus(unchecked, expr, "b"_symbol);
 /// ~~~
 ///
 /// note, could handle 2+ args
@@ -57,6 +152,32 @@ inline constexpr struct
     return op::op_invoke(
         op::plus{}, std::forward<T1>(t1), std::forward<T2>(t2));
   }
+
+  template <
+      class T1,
+      class T2,
+      class R = op::op_invoke_result_t<op::plus, T1&&, T2&&>>
+  static constexpr auto operator()(unchecked_t, T1&& t1, T2&& t2) -> R
+  {
+    return op::op_invoke(
+        unchecked, op::plus{}, std::forward<T1>(t1), std::forward<T2>(t2));
+  }
+
+  template <
+      class Alloc,
+      class T1,
+      class T2,
+      class R = op::op_invoke_result_t<op::plus, T1&&, T2&&>>
+  static constexpr auto
+  operator()(std::allocator_arg_t, const Alloc& alloc, T1&& t1, T2&& t2) -> R
+  {
+    return op::op_invoke(
+        std::allocator_arg,
+        alloc,
+        op::plus{},
+        std::forward<T1>(t1),
+        std::forward<T2>(t2));
+  }
 } plus{};
 
 /// operator+ overload
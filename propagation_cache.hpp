@@ -0,0 +1,293 @@
+#pragma once
+
+#include "constraint.hpp"
+#include "expression.hpp"
+#include "op/identity.hpp"
+#include "symbol.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace sym {
+
+namespace detail {
+
+struct propagation_key_hash
+{
+  [[nodiscard]]
+  auto operator()(const propagation_key& key) const -> std::size_t
+  {
+    return static_cast<std::size_t>(
+        hash_combine(key.structure, std::rotl(key.bounds, 32)));
+  }
+};
+
+/// number of subexpressions of `T` whose propagated constraints are cached
+///
+/// Symbols and `identity` expressions are cheaper to propagate than to look
+/// up and are not cached.
+///
+/// @{
+
+template <class T>
+inline constexpr auto cached_node_count = std::size_t{};
+
+template <class Op, class... Args, class Constraint>
+inline constexpr auto
+    cached_node_count<expression<Op, std::tuple<Args...>, Constraint>> =
+        std::size_t{not std::is_same_v<Op, op::identity>} +
+        (cached_node_count<Args> + ... + std::size_t{});
+
+/// @}
+
+}  // namespace detail
+
+/// bounded concurrent cache of propagated constraints
+///
+/// Entries are keyed by `propagation_key`, a structural hash of an expression
+/// and the bounds of its symbols, and are evicted with the CLOCK algorithm.
+/// The cache is split into shards, each guarded by its own mutex, so threads
+/// looking up different keys rarely contend.
+///
+/// `propagate` computes the keys of an expression and of all of its
+/// subexpressions in a single bottom-up pass, then looks up subexpressions
+/// top-down only on a miss, so that a subtree appearing in a new parent is not
+/// propagated again. Symbols and `identity` expressions are not cached.
+///
+/// Lookups compare keys only. Two expressions with equal keys are not
+/// distinguished, so a key collision silently returns the constraint
+/// propagated for the other expression. Collisions require both 64-bit halves
+/// of the key to be equal.
+///
+/// example:
+///
+/// ~~~{.cpp}
+/// auto cache = propagation_cache{4096};
+///
+/// cache.propagate(x + y);                       // miss
+/// cache.propagate(x + y);                       // hit
+/// cache.propagate(any_expression_view{x + y});  // hit
+/// ~~~
+///
+class propagation_cache
+{
+  struct entry
+  {
+    propagation_key key{};
+    constraint::any_ordered value{0.0, 0.0};
+    bool referenced{};
+  };
+
+  struct shard
+  {
+    std::mutex mutex{};
+    std::unordered_map<
+        propagation_key,
+        std::size_t,
+        detail::propagation_key_hash>
+        index{};
+    std::vector<entry> entries{};
+    std::size_t hand{};
+  };
+
+  std::size_t shard_capacity_;
+  std::unique_ptr<shard[]> shards_;
+  std::size_t shard_count_;
+  std::atomic<std::uint64_t> hits_{};
+  std::atomic<std::uint64_t> misses_{};
+
+  [[nodiscard]]
+  auto shard_for(const propagation_key& key) const -> shard&
+  {
+    return shards_[detail::propagation_key_hash{}(key) % shard_count_];
+  }
+
+  template <class... Ts>
+  auto propagate_node(const symbol<Ts...>& s, const propagation_key*)
+      -> constraint::any_ordered
+  {
+    return constraint::any_ordered{s.constraint()};
+  }
+
+  // `end` points past the key of `ex` in the post-order keys of the cached
+  // subexpressions
+  template <class Op, class... Args, class Constraint>
+  auto propagate_node(
+      const expression<Op, std::tuple<Args...>, Constraint>& ex,
+      const propagation_key* end) -> constraint::any_ordered
+  {
+    constexpr auto cached = not std::is_same_v<Op, op::identity>;
+
+    if constexpr (cached) {
+      if (const auto value = find(end[-1])) {
+        return *value;
+      }
+    }
+
+    auto child_end = end - std::ptrdiff_t{cached} -
+                     (detail::cached_node_count<Args> + ... + std::size_t{});
+
+    const auto values = std::apply(
+        [this, &child_end](const auto&... args) {
+          return std::array<constraint::any_ordered, sizeof...(Args)>{
+              propagate_node(
+                  args,
+                  child_end += detail::cached_node_count<
+                      std::remove_cvref_t<decltype(args)>>)...};
+        },
+        ex.args());
+
+    const auto value = std::apply(typename Op::constraint{}, values);
+    if constexpr (cached) {
+      insert(end[-1], value);
+    }
+    return value;
+  }
+
+public:
+  /// constructs a cache holding at most `capacity` entries
+  ///
+  explicit propagation_cache(std::size_t capacity, std::size_t shards = 16)
+      : shard_capacity_{(capacity + shards - 1) / shards},
+        shards_{std::make_unique<shard[]>(shards)},
+        shard_count_{shards}
+  {
+    assert(capacity != 0 and "cache capacity must be non-zero");
+    assert(shards != 0 and "cache must have at least one shard");
+
+    for (auto i = std::size_t{}; i != shard_count_; ++i) {
+      shards_[i].entries.reserve(shard_capacity_);
+      shards_[i].index.reserve(shard_capacity_);
+    }
+  }
+
+  /// cached value for `key`, if any
+  ///
+  [[nodiscard]]
+  auto
+  find(const propagation_key& key) -> std::optional<constraint::any_ordered>
+  {
+    auto& s = shard_for(key);
+    const auto lock = std::scoped_lock{s.mutex};
+
+    const auto it = s.index.find(key);
+    if (it == s.index.end()) {
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    auto& e = s.entries[it->second];
+    e.referenced = true;
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return e.value;
+  }
+
+  /// inserts or updates the value for `key`
+  ///
+  /// If the shard is full, the first entry found by the clock hand that has
+  /// not been referenced since the hand last passed is evicted.
+  ///
+  auto insert(const propagation_key& key, const constraint::any_ordered& value)
+      -> void
+  {
+    auto& s = shard_for(key);
+    const auto lock = std::scoped_lock{s.mutex};
+
+    if (const auto it = s.index.find(key); it != s.index.end()) {
+      s.entries[it->second].value = value;
+      return;
+    }
+
+    if (s.entries.size() != shard_capacity_) {
+      s.index.emplace(key, s.entries.size());
+      s.entries.push_back({key, value, false});
+      return;
+    }
+
+    while (s.entries[s.hand].referenced) {
+      s.entries[s.hand].referenced = false;
+      s.hand = (s.hand + 1) % shard_capacity_;
+    }
+
+    auto& victim = s.entries[s.hand];
+    s.index.erase(victim.key);
+    s.index.emplace(key, s.hand);
+    victim = {key, value, false};
+    s.hand = (s.hand + 1) % shard_capacity_;
+  }
+
+  /// propagated constraint of an expression, computed on a miss
+  ///
+  /// @{
+
+  template <class... Ts>
+  auto propagate(const expression<Ts...>& ex) -> constraint::any_ordered
+  {
+    auto keys = std::array<
+        propagation_key,
+        detail::cached_node_count<expression<Ts...>>>{};
+
+    auto out = keys.begin();
+    auto collect = [&out]<class Op, class... Us>(
+                       const expression<Op, Us...>&,
+                       const propagation_key& key) {
+      if constexpr (not std::is_same_v<Op, op::identity>) {
+        *out++ = key;
+      }
+    };
+    detail::structural_key(ex, collect);
+
+    return propagate_node(ex, keys.data() + keys.size());
+  }
+
+  auto propagate(const any_expression_view& ex) -> constraint::any_ordered
+  {
+    const auto key = ex.key();
+    if (const auto value = find(key)) {
+      return *value;
+    }
+
+    const auto value = ex.propagate();
+    insert(key, value);
+    return value;
+  }
+
+  /// @}
+
+  /// number of lookups that found a cached value
+  ///
+  [[nodiscard]]
+  auto hits() const -> std::uint64_t
+  {
+    return hits_.load(std::memory_order_relaxed);
+  }
+
+  /// number of lookups that did not find a cached value
+  ///
+  [[nodiscard]]
+  auto misses() const -> std::uint64_t
+  {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+  /// maximum number of cached values
+  ///
+  [[nodiscard]]
+  auto capacity() const -> std::size_t
+  {
+    return shard_capacity_ * shard_count_;
+  }
+};
+
+}  // namespace sym
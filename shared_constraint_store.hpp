@@ -0,0 +1,498 @@
+#pragma once
+
+#include "constraint.hpp"
+#include "detail/name_hash.hpp"
+#include "expression.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace sym {
+
+/// constraint store shared between processes through a memory-mapped file
+///
+/// The file contains only position-independent data: a header, a fixed
+/// capacity open-addressing table of slots, and a pool of interned names.
+/// Slots refer to names by offset into the pool so that every process may map
+/// the file at a different address.
+///
+/// A slot name is written once and then published. Slot bounds are guarded by
+/// a per-slot sequence lock so readers never block and never observe a torn
+/// interval. At most one process may write to a store at a time, any number of
+/// processes may read concurrently with that writer. If the writer dies in the
+/// middle of updating a key, readers give up on that key after a bounded
+/// number of retries instead of spinning forever.
+///
+/// Keys are symbol names or expressions. An expression is keyed by its
+/// `propagation_key` and stores its propagated constraint. The store only
+/// associates a key with a `constraint::any_ordered` value.
+///
+/// `create` replaces the file at a path with a new store and marks the
+/// previous store as replaced. Readers that mapped the previous store should
+/// check `replaced()` and open the path again to read the new store.
+///
+/// example:
+///
+/// ~~~{.cpp}
+/// // writer
+/// auto store = shared_constraint_store::create("/dev/shm/bounds", 1024);
+/// store.store(symbol{"x"}[constraint::positive]);
+/// store.store(x + y);
+///
+/// // reader, in another process
+/// auto store = shared_constraint_store::open("/dev/shm/bounds");
+/// const auto x = store.load("x");  // std::optional<constraint::any_ordered>
+/// const auto x_plus_y = store.load(x + y);
+///
+/// if (store.replaced()) {
+///   store = shared_constraint_store::open("/dev/shm/bounds");
+/// }
+/// ~~~
+///
+class [[nodiscard]] shared_constraint_store
+{
+  static constexpr auto magic = std::uint64_t{0x73796d2d73746f72U};
+  static constexpr auto layout_version = std::uint32_t{2};
+  static constexpr auto max_read_retries = 1U << 16U;
+
+  struct header
+  {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t capacity;
+    std::uint32_t pool_size;
+    std::atomic<std::uint32_t> pool_used;
+    std::atomic<std::uint32_t> count;
+    std::atomic<std::uint32_t> replaced;
+  };
+
+  struct slot
+  {
+    std::atomic<std::uint32_t> sequence;
+    std::atomic<std::uint32_t> name_size;  // 0 if unused
+    std::atomic<std::uint32_t> name_offset;
+    std::atomic<std::uint64_t> min_bits;
+    std::atomic<std::uint64_t> max_bits;
+  };
+
+  static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+  std::byte* base_{};
+  std::size_t size_{};
+
+  [[nodiscard]]
+  static constexpr auto
+  mapping_size(std::uint32_t capacity, std::uint32_t pool_size) -> std::size_t
+  {
+    return sizeof(header) + (std::size_t{capacity} * sizeof(slot)) +
+           pool_size;
+  }
+
+  [[nodiscard]]
+  auto head() const -> header&
+  {
+    return *std::launder(reinterpret_cast<header*>(base_));
+  }
+  [[nodiscard]]
+  auto slots() const -> slot*
+  {
+    return std::launder(reinterpret_cast<slot*>(base_ + sizeof(header)));
+  }
+  [[nodiscard]]
+  auto pool() const -> char*
+  {
+    return reinterpret_cast<char*>(
+        base_ + sizeof(header) + (std::size_t{head().capacity} * sizeof(slot)));
+  }
+
+  [[nodiscard]]
+  auto slot_name(const slot& s, std::uint32_t size) const -> std::string_view
+  {
+    return {pool() + s.name_offset.load(std::memory_order_relaxed), size};
+  }
+
+  // returns the slot for `name`, or the empty slot where `name` would be
+  // inserted, or `nullptr` if the table is full
+  [[nodiscard]]
+  auto find(std::string_view name) const -> slot*
+  {
+    const auto capacity = head().capacity;
+    const auto start = detail::name_hash(name) % capacity;
+
+    for (auto i = std::uint32_t{}; i != capacity; ++i) {
+      auto& s = slots()[(start + i) % capacity];
+      const auto size = s.name_size.load(std::memory_order_acquire);
+
+      if (size == 0 or slot_name(s, size) == name) {
+        return &s;
+      }
+    }
+    return nullptr;
+  }
+
+  [[noreturn]]
+  static auto throw_errno(const char* what) -> void
+  {
+    throw std::system_error{errno, std::generic_category(), what};
+  }
+
+  static auto map(int fd, std::size_t size) -> std::byte*
+  {
+    auto* const addr =
+        ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+      ::close(fd);
+      throw_errno("mmap");
+    }
+    ::close(fd);
+    return static_cast<std::byte*>(addr);
+  }
+
+  // key of an expression: a byte that cannot begin a symbol name followed
+  // by the hexadecimal digits of its `propagation_key`
+  using expression_key_type = std::array<char, 33>;
+
+  [[nodiscard]]
+  static auto expression_key(const propagation_key& key) -> expression_key_type
+  {
+    constexpr auto digits = std::string_view{"0123456789abcdef"};
+
+    auto k = expression_key_type{};
+    for (auto i = std::size_t{}; i != 16; ++i) {
+      const auto shift = 60 - (4 * i);
+      k[1 + i] = digits[(key.structure >> shift) & 0xfU];
+      k[17 + i] = digits[(key.bounds >> shift) & 0xfU];
+    }
+    return k;
+  }
+
+  // marks the store in an open file as replaced, if it is one
+  static auto mark_replaced(int fd) -> void
+  {
+    struct ::stat st{};
+    if (::fstat(fd, &st) == -1 or
+        static_cast<std::size_t>(st.st_size) < sizeof(header)) {
+      ::close(fd);
+      return;
+    }
+
+    auto* const addr = ::mmap(
+        nullptr, sizeof(header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      return;
+    }
+
+    auto& h = *std::launder(static_cast<header*>(addr));
+    if (std::atomic_ref{h.magic}.load(std::memory_order_acquire) == magic and
+        h.version == layout_version) {
+      h.replaced.store(1, std::memory_order_release);
+    }
+    ::munmap(addr, sizeof(header));
+  }
+
+  shared_constraint_store(std::byte* base, std::size_t size)
+      : base_{base}, size_{size}
+  {}
+
+public:
+  /// creates a store file, replacing any existing file, and maps it
+  ///
+  /// `capacity` is the maximum number of keys and `pool_size` the total number
+  /// of bytes available for interned names.
+  ///
+  /// The store is initialized in a temporary file that is then renamed to
+  /// `path`, so processes opening `path` never observe a partially
+  /// initialized store. Processes that have mapped a previous store at `path`
+  /// keep reading it, and `replaced()` becomes `true` for them.
+  ///
+  [[nodiscard]]
+  static auto create(
+      const std::filesystem::path& path,
+      std::uint32_t capacity,
+      std::uint32_t pool_size = 64U * 1024U) -> shared_constraint_store
+  {
+    assert(capacity != 0 and "store capacity must be non-zero");
+
+    auto temporary = path;
+    temporary += ".tmp." + std::to_string(::getpid());
+
+    const auto fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (fd == -1) {
+      throw_errno("open");
+    }
+
+    const auto size = mapping_size(capacity, pool_size);
+    if (::ftruncate(fd, static_cast<::off_t>(size)) == -1) {
+      ::close(fd);
+      ::unlink(temporary.c_str());
+      throw_errno("ftruncate");
+    }
+
+    auto store = shared_constraint_store{map(fd, size), size};
+
+    // begin the lifetime of the header and slots in the zero-filled file
+    auto& h = *::new (store.base_) header{};
+    for (auto i = std::uint32_t{}; i != capacity; ++i) {
+      ::new (store.base_ + sizeof(header) + (i * sizeof(slot))) slot{};
+    }
+    h.capacity = capacity;
+    h.pool_size = pool_size;
+    h.version = layout_version;
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic_ref{h.magic}.store(magic, std::memory_order_release);
+
+    // a reader opening `path` before the rename maps the previous store and
+    // still observes that it was replaced
+    const auto previous = ::open(path.c_str(), O_RDWR);
+
+    if (::rename(temporary.c_str(), path.c_str()) == -1) {
+      if (previous != -1) {
+        ::close(previous);
+      }
+      ::unlink(temporary.c_str());
+      throw_errno("rename");
+    }
+
+    if (previous != -1) {
+      mark_replaced(previous);
+    }
+
+    return store;
+  }
+
+  /// maps an existing store file
+  ///
+  [[nodiscard]]
+  static auto
+  open(const std::filesystem::path& path) -> shared_constraint_store
+  {
+    const auto fd = ::open(path.c_str(), O_RDWR);
+    if (fd == -1) {
+      throw_errno("open");
+    }
+
+    struct ::stat st{};
+    if (::fstat(fd, &st) == -1) {
+      ::close(fd);
+      throw_errno("fstat");
+    }
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    if (size < sizeof(header)) {
+      ::close(fd);
+      throw std::runtime_error{"not a shared constraint store"};
+    }
+
+    auto store = shared_constraint_store{map(fd, size), size};
+
+    auto& h = store.head();
+    if (std::atomic_ref{h.magic}.load(std::memory_order_acquire) != magic or
+        h.version != layout_version or h.capacity == 0 or
+        mapping_size(h.capacity, h.pool_size) != size) {
+      throw std::runtime_error{"not a shared constraint store"};
+    }
+
+    return store;
+  }
+
+  shared_constraint_store(const shared_constraint_store&) = delete;
+  auto operator=(const shared_constraint_store&)
+      -> shared_constraint_store& = delete;
+
+  shared_constraint_store(shared_constraint_store&& other) noexcept
+      : base_{std::exchange(other.base_, nullptr)},
+        size_{std::exchange(other.size_, 0)}
+  {}
+  auto operator=(shared_constraint_store&& other) noexcept
+      -> shared_constraint_store&
+  {
+    std::swap(base_, other.base_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+
+  ~shared_constraint_store()
+  {
+    if (base_ != nullptr) {
+      ::munmap(base_, size_);
+    }
+  }
+
+  /// `true` if `create` has replaced this store with a new file at its path
+  ///
+  /// Writes to a replaced store are not visible to processes that open the
+  /// path afterwards.
+  ///
+  [[nodiscard]]
+  auto replaced() const -> bool
+  {
+    return head().replaced.load(std::memory_order_acquire) != 0;
+  }
+
+  /// number of keys in the store
+  ///
+  [[nodiscard]]
+  auto size() const -> std::size_t
+  {
+    return head().count.load(std::memory_order_acquire);
+  }
+
+  /// inserts or updates the bounds associated with `key`
+  ///
+  /// returns `false` if `key` is new and the table or name pool is full.
+  ///
+  /// @{
+
+  auto store(std::string_view key, const constraint::any_ordered& c) -> bool
+  {
+    assert(not key.empty() and "store key must be non-empty");
+
+    auto* const s = find(key);
+    if (s == nullptr) {
+      return false;
+    }
+
+    if (s->name_size.load(std::memory_order_relaxed) == 0) {
+      auto& h = head();
+      const auto offset = h.pool_used.load(std::memory_order_relaxed);
+      if (key.size() > h.pool_size - offset) {
+        return false;
+      }
+
+      std::ranges::copy(key, pool() + offset);
+      h.pool_used.store(
+          offset + static_cast<std::uint32_t>(key.size()),
+          std::memory_order_relaxed);
+
+      s->min_bits.store(
+          std::bit_cast<std::uint64_t>(c.min()), std::memory_order_relaxed);
+      s->max_bits.store(
+          std::bit_cast<std::uint64_t>(c.max()), std::memory_order_relaxed);
+      s->name_offset.store(offset, std::memory_order_relaxed);
+      s->name_size.store(
+          static_cast<std::uint32_t>(key.size()), std::memory_order_release);
+      h.count.fetch_add(1, std::memory_order_release);
+      return true;
+    }
+
+    const auto seq = s->sequence.load(std::memory_order_relaxed);
+    s->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s->min_bits.store(
+        std::bit_cast<std::uint64_t>(c.min()), std::memory_order_relaxed);
+    s->max_bits.store(
+        std::bit_cast<std::uint64_t>(c.max()), std::memory_order_relaxed);
+
+    s->sequence.store(seq + 2, std::memory_order_release);
+    return true;
+  }
+
+  template <class Symbol>
+  auto store(const Symbol& s) -> bool
+  {
+    return store(s.name(), constraint::any_ordered{s.constraint()});
+  }
+
+  /// stores the propagated constraint of an expression
+  ///
+  template <class... Ts>
+  auto store(const expression<Ts...>& ex) -> bool
+  {
+    const auto key = expression_key(structural_key(ex));
+    return store(std::string_view{key.data(), key.size()}, propagate(ex));
+  }
+
+  /// @}
+
+  /// reads the bounds associated with `key`
+  ///
+  /// Never blocks. Retries only if a write to the same key is in progress.
+  ///
+  /// returns `std::nullopt` if `key` is not in the store, or if a write to the
+  /// same key is still in progress after a bounded number of retries, as when
+  /// the writer died in the middle of the write.
+  ///
+  [[nodiscard]]
+  auto
+  load(std::string_view key) const -> std::optional<constraint::any_ordered>
+  {
+    const auto* const s = find(key);
+    if (s == nullptr or s->name_size.load(std::memory_order_acquire) == 0) {
+      return std::nullopt;
+    }
+
+    for (auto retry = 0U; retry != max_read_retries; ++retry) {
+      const auto seq = s->sequence.load(std::memory_order_acquire);
+      if (seq % 2 != 0) {
+        continue;
+      }
+
+      const auto min_bits = s->min_bits.load(std::memory_order_relaxed);
+      const auto max_bits = s->max_bits.load(std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s->sequence.load(std::memory_order_relaxed) == seq) {
+        return constraint::any_ordered{
+            std::bit_cast<constraint::real_type>(min_bits),
+            std::bit_cast<constraint::real_type>(max_bits)};
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// reads the propagated constraint stored for an expression
+  ///
+  template <class... Ts>
+  [[nodiscard]]
+  auto load(const expression<Ts...>& ex) const
+      -> std::optional<constraint::any_ordered>
+  {
+    const auto key = expression_key(structural_key(ex));
+    return load(std::string_view{key.data(), key.size()});
+  }
+
+  /// visits every key in the store
+  ///
+  /// Keys are views into the mapped file and remain valid for the lifetime of
+  /// the store object. Keys of expressions begin with `'\0'`. Keys that
+  /// cannot be read, as described in `load`, are skipped.
+  ///
+  template <class F>
+  auto for_each(F f) const -> void
+  {
+    for (auto i = std::uint32_t{}; i != head().capacity; ++i) {
+      const auto& s = slots()[i];
+      if (const auto size = s.name_size.load(std::memory_order_acquire);
+          size != 0) {
+        const auto key = slot_name(s, size);
+        if (const auto c = load(key)) {
+          f(key, *c);
+        }
+      }
+    }
+  }
+};
+
+}  // namespace sym
@@ -1,9 +1,16 @@
 #pragma once
 
 // IWYU pragma: begin_exports
+#include "arena.hpp"
 #include "constraint.hpp"
+#include "discrete.hpp"
+#include "dual.hpp"
 #include "expression.hpp"
+#include "fixed_point.hpp"
 #include "op/identity.hpp"
 #include "op/plus.hpp"
+#include "propagation_cache.hpp"
 #include "symbol.hpp"
+#include "symbol_index.hpp"
+#include "validate_batch.hpp"
 // IWYU pragma: end_exports
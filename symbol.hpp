@@ -1,16 +1,24 @@
 #pragma once
 
 #include "constraint.hpp"
+#include "detail/descriptor.hpp"
+#include "detail/name_hash.hpp"
+#include "detail/print.hpp"
 #include "detail/static_instance.hpp"
+#include "discrete.hpp"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <concepts>
 #include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include <ostream>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 namespace sym {
 namespace detail {
@@ -38,10 +46,17 @@ string_constant
   }
 };
 
+/// symbol name known at compile time
+///
+/// `_symbol` literals with the same spelling have the same `string_literal`
+/// type, so the type identifies the name. `hash` is computed once per name.
+///
 template <const char* begin, std::size_t size>
 struct [[nodiscard]]
 string_literal
 {
+  static constexpr auto hash = name_hash(std::string_view{begin, size});
+
   [[nodiscard]]
   constexpr operator std::string_view() const
   {
@@ -72,6 +87,14 @@ struct symbol_base
     requires std::is_same_v<Symbol, std::remove_cvref_t<Self>>
   friend auto operator<<(std::ostream& os, const Self& self) -> auto&
   {
+#ifdef SYM_COMPACT_CODEGEN
+    // symbol views have a runtime constraint and no descriptor
+    if constexpr (std::default_initializable<
+                      typename Symbol::constraint_type>) {
+      return detail::print(
+          os, detail::node_descriptor_v<Symbol>, detail::symbol_names(self));
+    }
+#endif
     os << "symbol(" << self.name() << ") [" << self.constraint() << "]";
     return os;
   }
@@ -90,9 +113,8 @@ class [[nodiscard]] symbol : symbol_base<symbol<String, Constraint>>
 public:
   using constraint_type = Constraint;
 
-  static constexpr auto is_unconstrained = std::is_same<
-      constraint_type,
-      std::remove_cvref_t<decltype(constraint::real)>>{};
+  static constexpr auto is_unconstrained =
+      std::bool_constant<constraint::is_unconstrained_v<constraint_type>>{};
 
   symbol()
     requires (detail::is_string_literal_v<String>)
@@ -100,6 +122,27 @@ public:
 
   constexpr explicit symbol(String name) : s_{std::move(name)} {}
 
+  /// allocator-extended constructors
+  ///
+  /// Makes `symbol` a uses-allocator type if `String` is one.
+  ///
+  /// @{
+
+  template <class Alloc>
+    requires std::uses_allocator_v<String, Alloc>
+  constexpr symbol(
+      std::allocator_arg_t, const Alloc& alloc, const symbol& other)
+      : s_{other.s_, alloc}
+  {}
+
+  template <class Alloc>
+    requires std::uses_allocator_v<String, Alloc>
+  constexpr symbol(std::allocator_arg_t, const Alloc& alloc, symbol&& other)
+      : s_{std::move(other.s_), alloc}
+  {}
+
+  /// @}
+
   [[nodiscard]]
   constexpr auto name() const -> std::string_view
   {
@@ -115,10 +158,11 @@ public:
   [[nodiscard]]
   constexpr auto operator[](Refined c) && -> symbol<String, Refined>
   {
-    const auto is_narrowing =
-        [&c1 = this->constraint(), &c2 = std::as_const(c)] {
-          return c1.min() <= c2.min() and c1.max() >= c2.max();
-        };
+    const auto is_narrowing = [&c1 = this->constraint(),
+                               &c2 = std::as_const(c)] {
+      using constraint::refines;
+      return refines(c2, c1);
+    };
 
     assert(is_narrowing() and  //
            "constraint value does not refine existing constraint on symbol.");
@@ -129,18 +173,34 @@ public:
 template <class String>
 symbol(String) -> symbol<std::string>;
 
+symbol(std::pmr::string) -> symbol<std::pmr::string>;
+
 // non-owning type-erased view of a symbol
 class [[nodiscard]] any_symbol_view : symbol_base<any_symbol_view>
 {
   std::string_view s_;
   constraint::any_ordered c_;
+  const void* domain_{};
 
 public:
   using constraint_type = constraint::any_ordered;
 
   template <class Symbol>
   constexpr explicit any_symbol_view(const Symbol& s)
-      : s_{s.name()}, c_{s.constraint()}
+      : s_{s.name()},
+        c_{s.constraint()},
+        domain_{detail::domain_identity<typename Symbol::constraint_type>}
+  {}
+
+  /// view of a symbol with a constraint described by `c`
+  ///
+  /// Equal to the view of a symbol with the same name and constraint type.
+  ///
+  constexpr any_symbol_view(
+      std::string_view name, const detail::constraint_descriptor& c)
+      : s_{name},
+        c_{detail::min_value(c), detail::max_value(c)},
+        domain_{c.domain}
   {}
 
   [[nodiscard]]
@@ -154,6 +214,19 @@ public:
   {
     return c_;
   }
+
+  /// identity of the values of a constraint that is not described by its
+  /// bounds
+  ///
+  /// `nullptr` for ordered constraints that are not discrete. Otherwise equal
+  /// for symbols with constraints that have the same values, such as an
+  /// integer range and the small domain with the same elements.
+  ///
+  [[nodiscard]]
+  constexpr auto domain() const -> const void*
+  {
+    return domain_;
+  }
 };
 
 inline namespace literals {
@@ -168,3 +241,8 @@ consteval auto operator""_symbol()
 
 }  // namespace literals
 }  // namespace sym
+
+template <class String, class Constraint, class Alloc>
+struct std::uses_allocator<sym::symbol<String, Constraint>, Alloc>
+    : std::uses_allocator<String, Alloc>
+{};
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "detail/string_hash.hpp"
+#include "symbol.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sym {
+
+/// expression visitor collecting the names of all symbols
+///
+/// Names are collected in visitation order and may contain duplicates.
+///
+template <class Container = std::vector<std::string_view>>
+struct collect_symbol_names
+{
+  Container names{};
+
+  template <class... Ts>
+  constexpr auto operator()(const symbol<Ts...>& s)
+  {
+    names.emplace_back(s.name());
+  }
+  constexpr auto operator()(const any_symbol_view& s)
+  {
+    names.emplace_back(s.name());
+  }
+};
+
+/// reverse dependency index from symbols to the expressions that use them
+///
+/// Symbol names are interned once. Each symbol maps to a sorted posting list
+/// of expression ids and each expression stores the ids of the symbols it
+/// uses, so memory scales with the total number of distinct symbol
+/// occurrences over all indexed expressions. Ids of erased expressions and of
+/// symbols no longer used by any expression are reused, so memory does not
+/// grow with the number of expressions ever inserted.
+///
+/// example:
+///
+/// ~~~{.cpp}
+/// auto index = symbol_index{};
+/// const auto e1 = index.insert(x + y);
+/// const auto e2 = index.insert(y + z);
+///
+/// index.expressions_using("y");             // {e1, e2}
+/// index.expressions_using_all({"x", "y"});  // {e1}
+///
+/// index.erase(e1);
+/// index.expressions_using("y");             // {e2}
+/// ~~~
+///
+class symbol_index
+{
+public:
+  using expression_id = std::uint32_t;
+
+private:
+  using symbol_id = std::uint32_t;
+
+  struct posting
+  {
+    // key of the interned name in `symbol_ids_`, empty if the id is free
+    std::string_view name{};
+    std::vector<expression_id> ids{};
+  };
+
+  std::unordered_map<
+      std::string,
+      symbol_id,
+      detail::string_hash,
+      std::equal_to<>>
+      symbol_ids_{};
+  std::vector<posting> postings_{};
+  std::vector<std::vector<symbol_id>> symbols_{};
+  std::vector<symbol_id> free_symbols_{};
+  std::vector<expression_id> free_expressions_{};
+  std::size_t size_{};
+
+  [[nodiscard]]
+  auto intern(std::string_view name) -> symbol_id
+  {
+    if (const auto it = symbol_ids_.find(name); it != symbol_ids_.end()) {
+      return it->second;
+    }
+
+    auto id = static_cast<symbol_id>(postings_.size());
+    if (free_symbols_.empty()) {
+      postings_.emplace_back();
+    } else {
+      id = free_symbols_.back();
+      free_symbols_.pop_back();
+    }
+
+    // references to unordered_map keys are stable
+    postings_[id].name = symbol_ids_.emplace(name, id).first->first;
+    return id;
+  }
+
+  auto release(symbol_id id) -> void
+  {
+    auto& p = postings_[id];
+    symbol_ids_.erase(symbol_ids_.find(p.name));
+    p = {};
+    free_symbols_.push_back(id);
+  }
+
+public:
+  /// adds an expression to the index
+  ///
+  /// The id of an erased expression may be assigned to a later expression.
+  ///
+  template <class Expression>
+  auto insert(const Expression& ex) -> expression_id
+  {
+    auto v = collect_symbol_names<>{};
+    ex.visit(std::ref(v));
+
+    auto ids = std::vector<symbol_id>{};
+    ids.reserve(v.names.size());
+    std::ranges::transform(
+        v.names, std::back_inserter(ids), [this](auto name) {
+          return intern(name);
+        });
+
+    std::ranges::sort(ids);
+    const auto [first, last] = std::ranges::unique(ids);
+    ids.erase(first, last);
+    ids.shrink_to_fit();
+
+    auto id = static_cast<expression_id>(symbols_.size());
+    if (free_expressions_.empty()) {
+      symbols_.emplace_back();
+    } else {
+      id = free_expressions_.back();
+      free_expressions_.pop_back();
+    }
+
+    for (const auto s : ids) {
+      auto& posting = postings_[s].ids;
+      posting.insert(std::ranges::upper_bound(posting, id), id);
+    }
+    symbols_[id] = std::move(ids);
+    ++size_;
+
+    return id;
+  }
+
+  /// removes an expression from the index
+  ///
+  /// Symbols no longer used by any indexed expression are removed as well.
+  ///
+  auto erase(expression_id id) -> void
+  {
+    assert(contains(id) and "expression id is not in the index");
+
+    for (const auto s : symbols_[id]) {
+      auto& posting = postings_[s].ids;
+      posting.erase(std::ranges::lower_bound(posting, id));
+      if (posting.empty()) {
+        release(s);
+      }
+    }
+    symbols_[id] = std::vector<symbol_id>{};
+    free_expressions_.push_back(id);
+    --size_;
+  }
+
+  /// `true` if an expression id refers to an indexed expression
+  ///
+  /// Every expression uses at least one symbol, so an empty symbol list marks
+  /// an erased expression.
+  ///
+  [[nodiscard]]
+  auto contains(expression_id id) const -> bool
+  {
+    return id < symbols_.size() and not symbols_[id].empty();
+  }
+
+  /// number of indexed expressions
+  ///
+  [[nodiscard]]
+  auto size() const -> std::size_t
+  {
+    return size_;
+  }
+
+  /// sorted ids of the expressions using symbol `name`
+  ///
+  [[nodiscard]]
+  auto expressions_using(std::string_view name) const
+      -> std::span<const expression_id>
+  {
+    if (const auto it = symbol_ids_.find(name); it != symbol_ids_.end()) {
+      return postings_[it->second].ids;
+    }
+    return {};
+  }
+
+  /// sorted ids of the expressions using every symbol in `names`
+  ///
+  [[nodiscard]]
+  auto expressions_using_all(std::span<const std::string_view> names) const
+      -> std::vector<expression_id>
+  {
+    auto lists = std::vector<std::span<const expression_id>>{};
+    lists.reserve(names.size());
+    std::ranges::transform(
+        names, std::back_inserter(lists), [this](auto name) {
+          return expressions_using(name);
+        });
+
+    if (lists.empty()) {
+      return {};
+    }
+
+    // intersect starting from the shortest list to bound the work by its size
+    std::ranges::sort(
+        lists, std::ranges::less{}, [](auto list) { return list.size(); });
+
+    auto result =
+        std::vector<expression_id>(lists.front().begin(), lists.front().end());
+    auto scratch = std::vector<expression_id>{};
+
+    for (const auto list : std::span{lists}.subspan(1)) {
+      scratch.clear();
+      std::ranges::set_intersection(result, list, std::back_inserter(scratch));
+      std::swap(result, scratch);
+    }
+
+    return result;
+  }
+
+  [[nodiscard]]
+  auto
+  expressions_using_all(std::initializer_list<std::string_view> names) const
+      -> std::vector<expression_id>
+  {
+    return expressions_using_all(std::span{names.begin(), names.size()});
+  }
+};
+
+}  // namespace sym
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "expression.hpp"
+#include "symbol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace sym {
+
+/// options for `validate_batch`
+///
+struct batch_options
+{
+  /// number of worker threads. `0` uses the hardware concurrency.
+  ///
+  std::size_t threads{};
+
+  /// number of expressions processed by a worker at a time. Rounded up to a
+  /// multiple of 64 so that no two workers write the same word of the result.
+  ///
+  std::size_t chunk_size{1024};
+};
+
+/// result of `validate_batch`
+///
+/// Stores one bit per expression, set if the expression has inconsistent
+/// symbolic constraints.
+///
+class [[nodiscard]] batch_result
+{
+  static constexpr auto word_bits = std::size_t{64};
+
+  std::vector<std::uint64_t> failed_{};
+  std::size_t size_{};
+
+  friend auto
+  validate_batch(std::span<const any_expression_view>, batch_options)
+      -> batch_result;
+
+  explicit batch_result(std::size_t size)
+      : failed_((size + word_bits - 1) / word_bits), size_{size}
+  {}
+
+public:
+  /// number of validated expressions
+  ///
+  [[nodiscard]]
+  auto size() const -> std::size_t
+  {
+    return size_;
+  }
+
+  /// `true` if expression `i` has consistent symbolic constraints
+  ///
+  [[nodiscard]]
+  auto ok(std::size_t i) const -> bool
+  {
+    assert(i < size_);
+    return ((failed_[i / word_bits] >> (i % word_bits)) & 1U) == 0;
+  }
+
+  /// number of expressions with inconsistent symbolic constraints
+  ///
+  [[nodiscard]]
+  auto failure_count() const -> std::size_t
+  {
+    auto n = std::size_t{};
+    for (const auto word : failed_) {
+      n += static_cast<std::size_t>(std::popcount(word));
+    }
+    return n;
+  }
+
+  /// indices of expressions with inconsistent symbolic constraints
+  ///
+  [[nodiscard]]
+  auto failures() const -> std::vector<std::size_t>
+  {
+    auto indices = std::vector<std::size_t>{};
+    indices.reserve(failure_count());
+
+    for (auto w = std::size_t{}; w != failed_.size(); ++w) {
+      for (auto word = failed_[w]; word != 0; word &= word - 1) {
+        indices.push_back(
+            (w * word_bits) + static_cast<std::size_t>(std::countr_zero(word)));
+      }
+    }
+    return indices;
+  }
+
+  /// `true` if all expressions have consistent symbolic constraints
+  ///
+  [[nodiscard]]
+  explicit operator bool() const
+  {
+    return std::ranges::all_of(failed_, [](auto word) { return word == 0; });
+  }
+};
+
+/// validates the symbolic constraints of many expressions
+///
+/// Performs the same check as the `expression` constructor, for expressions
+/// constructed with `unchecked`. Expressions are split into chunks that are
+/// claimed by worker threads. Each worker reuses a single scratch buffer for
+/// all of its expressions and writes failures to words of the result bitmap
+/// that no other worker touches.
+///
+/// example:
+///
+/// ~~~{.cpp}
+/// auto expressions = std::vector<decltype(x + y)>{};
+/// for (...) {
+///   expressions.push_back(plus(unchecked, x, y));
+/// }
+///
+/// auto views = std::vector<any_expression_view>{};
+/// for (const auto& ex : expressions) {
+///   views.emplace_back(ex);
+/// }
+///
+/// const auto result = validate_batch(views);
+/// for (const auto i : result.failures()) {
+///   std::cerr << "expression " << i << " is inconsistent\n";
+/// }
+/// ~~~
+///
+inline auto validate_batch(
+    std::span<const any_expression_view> expressions,
+    batch_options options = {}) -> batch_result
+{
+  constexpr auto word_bits = batch_result::word_bits;
+  const auto chunk_size = std::max(
+      word_bits, (options.chunk_size + word_bits - 1) / word_bits * word_bits);
+
+  auto result = batch_result{expressions.size()};
+
+  const auto chunks = (expressions.size() + chunk_size - 1) / chunk_size;
+  const auto hardware_threads = std::max(
+      std::size_t{1}, std::size_t{std::thread::hardware_concurrency()});
+  const auto threads = std::min(
+      chunks, options.threads != 0 ? options.threads : hardware_threads);
+
+  auto next_chunk = std::atomic<std::size_t>{};
+
+  const auto work = [&] {
+    auto scratch = std::vector<any_symbol_view>{};
+
+    for (auto chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+         chunk < chunks;
+         chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+      const auto first = chunk * chunk_size;
+      const auto last = std::min(first + chunk_size, expressions.size());
+
+      for (auto i = first; i != last; ++i) {
+        scratch.clear();
+        expressions[i].symbols(scratch);
+
+        if (not detail::has_consistent_constraints(scratch)) {
+          result.failed_[i / word_bits] |= std::uint64_t{1} << (i % word_bits);
+        }
+      }
+    }
+  };
+
+  {
+    auto workers = std::vector<std::jthread>{};
+    workers.reserve(threads > 0 ? threads - 1 : 0);
+    for (auto t = std::size_t{1}; t < threads; ++t) {
+      workers.emplace_back(work);
+    }
+    work();
+  }
+
+  return result;
+}
+
+}  // namespace sym